@@ -8,6 +8,10 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 
 // ---------------------------------------------------------
 // CORRECCIN: Solo incluimos la matriz principal y Quat.
@@ -15,6 +19,17 @@
 // ---------------------------------------------------------
 #include "Matrix4x4.hpp"
 #include "Quat.hpp"
+#include "Affine3x4.hpp"
+#include "Simd.hpp"
+#include "TransformHierarchy.hpp"
+#include "ParallelTransform.hpp"
+#include "DualQuat.hpp"
+#include "Skinning.hpp"
+#include "Bounds.hpp"
+#include "Quantize.hpp"
+#include "FrameArena.hpp"
+#include "Transform.hpp"
+#include "TransformStream.hpp"
 
 // -------------------- Colors ANSI ----------------------
 static constexpr const char* GREEN = "\x1b[32m";
@@ -27,7 +42,7 @@ static constexpr const char* RESET = "\x1b[0m";
 static constexpr double PI = 3.14159265358979323846;
 static constexpr double TOL = 1e-4;
 // Asumimos que Matrix4x4 tiene Identity()
-static const Matrix4x4 M4_IDENTITY = Matrix4x4::Identity();
+static constexpr Matrix4x4 M4_IDENTITY = Matrix4x4::Identity();
 
 // -------------------- Helpers Auxiliares -----------------
 
@@ -201,6 +216,1218 @@ static void EX3_Test_Decomposition(Suite& S) {
     S.add(Mat3Eq(r_in, r_out, 1e-4), "Get Rotation (Calculado)", "Matriz normalizada");
 }
 
+static void LOT_Test_TransformBatch(Suite& S) {
+    std::mt19937 g(7);
+    const std::size_t N = 257;
+    std::vector<Vec3> pts(N), out(N);
+    std::vector<double> xs(N), ys(N), zs(N), ox(N), oy(N), oz(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        pts[i] = RandVec(g);
+        xs[i] = pts[i].x; ys[i] = pts[i].y; zs[i] = pts[i].z;
+    }
+
+    Matrix4x4 M = Matrix4x4::FromTRS(RandVec(g), Matrix3x3::RotationAxisAngle(RandUnit(g), 0.7), { 2.0, 0.5, 1.5 });
+    Matrix4x4 P = M;
+    P.At(3, 2) = -0.25; P.At(3, 3) = 0.5;
+
+    // La version punto a punto es la referencia
+    auto check = [&](const Matrix4x4& A, bool points, double eps) {
+        if (points) { A.TransformPoints(pts, out); A.TransformPoints(xs, ys, zs, ox, oy, oz); }
+        else { A.TransformVectors(pts, out); A.TransformVectors(xs, ys, zs, ox, oy, oz); }
+        for (std::size_t i = 0; i < N; ++i) {
+            Vec3 ref = points ? A.TransformPoint(pts[i]) : A.TransformVector(pts[i]);
+            if (!VecEq(out[i], ref, eps) || !VecEq({ ox[i], oy[i], oz[i] }, ref, eps)) return false;
+        }
+        return true;
+    };
+    S.add(check(M, true, 1e-9), "TransformPoints (afin, AoS/SoA)", "== TransformPoint");
+    S.add(check(M, false, 1e-9), "TransformVectors (afin, AoS/SoA)", "== TransformVector");
+    S.add(check(P, true, 1e-9), "TransformPoints (proyectiva, AoS/SoA)", "Division por w");
+
+    bool threw = false;
+    try { M.TransformPoints(std::span<const Vec3>(pts), std::span<Vec3>(out).first(N - 1)); }
+    catch (const std::invalid_argument&) { threw = true; }
+    S.add(threw, "TransformPoints (mida incorrecta)", "Lanza invalid_argument");
+}
+
+static void SIMD_Test_Multiply(Suite& S) {
+    std::mt19937 g(11);
+    std::uniform_real_distribution<double> U(-5.0, 5.0);
+    const int N = 64;
+    std::vector<Matrix4x4> A(N), B(N);
+    std::vector<Vec4> V(N);
+    for (int i = 0; i < N; ++i) {
+        for (int k = 0; k < 16; ++k) { A[i].m[k] = U(g); B[i].m[k] = U(g); }
+        V[i] = Vec4(U(g), U(g), U(g), U(g));
+    }
+
+    const SimdLevel detected = DetectSimdLevel();
+    const SimdLevel active = GetSimdLevel();
+
+    // Referencia: el bucle escalar
+    SetSimdLevel(SimdLevel::Scalar);
+    std::vector<Matrix4x4> refM(N);
+    std::vector<Vec4> refV(N);
+    for (int i = 0; i < N; ++i) { refM[i] = A[i].Multiply(B[i]); refV[i] = A[i].Multiply(V[i]); }
+
+    for (int l = static_cast<int>(SimdLevel::SSE2); l <= static_cast<int>(detected); ++l) {
+        SimdLevel level = static_cast<SimdLevel>(l);
+        SetSimdLevel(level);
+        // Sin FMA el orden de las sumas es el mismo: resultado identico
+        double eps = (level == SimdLevel::FMA) ? 1e-12 : 0.0;
+        bool okM = true, okV = true;
+        for (int i = 0; i < N; ++i) {
+            if (!Mat4Eq(A[i].Multiply(B[i]), refM[i], eps)) okM = false;
+            Vec4 r = A[i].Multiply(V[i]);
+            if (!Nearly(r.x, refV[i].x, eps) || !Nearly(r.y, refV[i].y, eps) ||
+                !Nearly(r.z, refV[i].z, eps) || !Nearly(r.w, refV[i].w, eps)) okV = false;
+        }
+        S.add(okM, std::string("Multiply(Matrix4x4) ") + ToString(level), "== escalar");
+        S.add(okV, std::string("Multiply(Vec4) ") + ToString(level), "== escalar");
+    }
+    SetSimdLevel(active);
+    S.add(true, "Nivel detectado", ToString(detected));
+}
+
+static void AFF_Test_Affine3x4(Suite& S) {
+    std::mt19937 g(3);
+    bool mulOk = true, fastOk = true, ptOk = true, roundOk = true;
+    for (int i = 0; i < 20; ++i) {
+        Matrix4x4 A = Matrix4x4::FromTRS(RandVec(g), Matrix3x3::RotationAxisAngle(RandUnit(g), 0.3 * i), { 1.0, 2.0, 0.5 });
+        Matrix4x4 B = Matrix4x4::FromTRS(RandVec(g), Matrix3x3::RotationAxisAngle(RandUnit(g), -0.2 * i), { 3.0, 1.0, 1.0 });
+        Matrix4x4 AB = A.Multiply(B);
+
+        Affine3x4 a = Affine3x4::FromMatrix4x4(A), b = Affine3x4::FromMatrix4x4(B);
+        if (!Mat4Eq((a * b).ToMatrix4x4(), AB, 1e-9)) mulOk = false;
+        if (!Mat4Eq(A.MultiplyAffine(B), AB, 1e-9)) fastOk = false;
+        Vec3 p = RandVec(g);
+        if (!VecEq(a.TransformPoint(p), A.TransformPoint(p), 1e-9) ||
+            !VecEq(a.TransformVector(p), A.TransformVector(p), 1e-9)) ptOk = false;
+        if (!Mat4Eq(a.ToMatrix4x4(), A, 0.0)) roundOk = false;
+    }
+    S.add(mulOk, "Affine3x4::Multiply", "== Matrix4x4::Multiply");
+    S.add(fastOk, "Matrix4x4::MultiplyAffine", "== Multiply");
+    S.add(ptOk, "Affine3x4 TransformPoint/Vector", "== Matrix4x4");
+    S.add(roundOk, "FromMatrix4x4 -> ToMatrix4x4", "Exacto");
+
+    Quat q = Quat::FromAxisAngle({ 1,1,0 }, 0.8);
+    S.add(Mat4Eq(Affine3x4::FromTRS({ 1,2,3 }, q, { 2,2,2 }).ToMatrix4x4(), Matrix4x4::FromTRS({ 1,2,3 }, q, { 2,2,2 })),
+        "Affine3x4::FromTRS(Quat)", "== Matrix4x4::FromTRS");
+
+    Matrix4x4 P = Matrix4x4::Identity();
+    P.At(3, 2) = -1.0; P.At(3, 3) = 0.0;
+    bool threw = false;
+    try { Affine3x4::FromMatrix4x4(P); }
+    catch (const std::runtime_error&) { threw = true; }
+    S.add(threw, "FromMatrix4x4 (proyectiva)", "Lanza runtime_error");
+}
+
+static void F32_Test_Float(Suite& S) {
+    std::mt19937 g(5);
+    bool trsOk = true, quatOk = true, simdOk = true, ptOk = true;
+    const SimdLevel active = GetSimdLevel();
+    for (int i = 0; i < 20; ++i) {
+        Vec3 t = RandVec(g);
+        Quat q = Quat::FromAxisAngle(RandUnit(g), 0.25 * i);
+        Vec3 s{ 1.5, 0.5, 2.0 };
+        Matrix4x4 Md = Matrix4x4::FromTRS(t, q, s);
+        Matrix4x4f Mf = Matrix4x4f::FromTRS(t.Cast<float>(), q.Cast<float>(), s.Cast<float>());
+        if (!Mat4Eq(Mf.Cast<double>(), Md, 1e-5)) trsOk = false;
+
+        Quatf qf = Quatf::FromMatrix3x3(q.ToMatrix3x3().Cast<float>());
+        double d = std::fabs(qf.s * q.s + qf.x * q.x + qf.y * q.y + qf.z * q.z);
+        if (!Nearly(d, 1.0, 1e-5)) quatOk = false;
+
+        Vec3f p = RandVec(g).Cast<float>();
+        if (!VecEq(Mf.TransformPoint(p).Cast<double>(), Md.TransformPoint(p.Cast<double>()), 1e-4)) ptOk = false;
+
+        // Kernels SIMD float contra el escalar
+        Matrix4x4f Nf = Matrix4x4f::FromTRS(RandVec(g).Cast<float>(), qf, { 1, 2, 3 });
+        SetSimdLevel(SimdLevel::Scalar);
+        Matrix4x4f ref = Mf.Multiply(Nf);
+        SetSimdLevel(active);
+        if (!Mat4Eq(Mf.Multiply(Nf).Cast<double>(), ref.Cast<double>(), 1e-4)) simdOk = false;
+    }
+    S.add(trsOk, "Matrix4x4f::FromTRS", "== double (1e-5)");
+    S.add(quatOk, "Quatf::FromMatrix3x3", "== double (1e-5)");
+    S.add(ptOk, "Matrix4x4f::TransformPoint", "== double (1e-4)");
+    S.add(simdOk, std::string("Matrix4x4f::Multiply ") + ToString(active), "== escalar");
+    S.add(Matrix3x3f::RotationAxisAngle({ 0,0,1 }, 0.3f).IsRotation(), "Matrix3x3f::IsRotation", "Tolerancia float");
+}
+
+static void CHK_Test_Unchecked(Suite& S) {
+    Vec3 t_in{ 1.0, -2.0, 3.0 };
+    Quat q_in = Quat::FromAxisAngle({ 1,2,3 }, 0.9);
+    Vec3 s_in{ 2.0, 0.5, 3.0 };
+    Matrix4x4 M = Matrix4x4::FromTRS(t_in, q_in, s_in);
+
+    bool same = VecEq(M.GetTranslationUnchecked(), M.GetTranslation(), 0.0)
+        && VecEq(M.GetScaleUnchecked(), M.GetScale(), 0.0)
+        && Mat3Eq(M.GetRotationUnchecked(), M.GetRotation(), 0.0)
+        && Mat3Eq(M.GetRotationScaleUnchecked(), M.GetRotationScale(), 0.0);
+    Quat qa = M.GetRotationQuatUnchecked(), qb = M.GetRotationQuat();
+    same = same && Nearly(qa.s, qb.s, 0.0) && Nearly(qa.x, qb.x, 0.0) && Nearly(qa.y, qb.y, 0.0) && Nearly(qa.z, qb.z, 0.0);
+    S.add(same, "Getters Unchecked", "== checked");
+
+    Matrix4x4 A = M, B = M;
+    A.SetScale({ 1, 1, 1 }); B.SetScaleUnchecked({ 1, 1, 1 });
+    A.SetRotation(Quat{}); B.SetRotationUnchecked(Quat{});
+    S.add(Mat4Eq(A, B, 0.0), "Setters Unchecked", "== checked");
+
+    Expected<Quat> eq = M.TryGetRotationQuat();
+    S.add(eq && Nearly(std::fabs(eq->s * q_in.s + eq->x * q_in.x + eq->y * q_in.y + eq->z * q_in.z), 1.0),
+        "TryGetRotationQuat (TRS)", "Valor correcto");
+
+    Matrix4x4 P = Matrix4x4::Identity();
+    P.At(3, 2) = -1.0; P.At(3, 3) = 0.0;
+    S.add(P.TryGetTranslation().error == MathError::NotAffine && P.TrySetScale({ 1,1,1 }) == MathError::NotAffine,
+        "Try* (proyectiva)", ToString(MathError::NotAffine));
+
+    Matrix4x4 Sh = Matrix4x4::Identity();
+    Sh.At(0, 1) = 0.5;
+    S.add(Sh.TryGetRotationQuat().error == MathError::NotRotation, "TryGetRotationQuat (cizalla)", ToString(MathError::NotRotation));
+}
+
+static void DEC_Test_Decompose(Suite& S) {
+    std::mt19937 g(21);
+    const std::size_t N = 32;
+    std::vector<Matrix4x4> Ms(N);
+    for (std::size_t i = 0; i < N; ++i)
+        Ms[i] = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), 0.2 * i), { 0.5 + i * 0.1, 2.0, 1.0 + i * 0.05 });
+
+    bool single = true;
+    for (const Matrix4x4& M : Ms) {
+        Vec3 t, s; Quat q;
+        M.Decompose(t, q, s);
+        Quat qr = M.GetRotationQuat();
+        double d = std::fabs(q.s * qr.s + q.x * qr.x + q.y * qr.y + q.z * qr.z);
+        if (!VecEq(t, M.GetTranslation(), 1e-12) || !VecEq(s, M.GetScale(), 1e-12) || !Nearly(d, 1.0, 1e-12)) single = false;
+    }
+    S.add(single, "Decompose", "== GetTranslation/GetRotationQuat/GetScale");
+
+    std::vector<Vec3> ts(N), ss(N);
+    std::vector<Quat> qs(N);
+    Matrix4x4::DecomposeMany(Ms, ts, qs, ss);
+    bool batch = true;
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 t, s; Quat q;
+        Ms[i].DecomposeUnchecked(t, q, s);
+        if (!VecEq(t, ts[i], 0.0) || !VecEq(s, ss[i], 0.0) || q.s != qs[i].s || q.x != qs[i].x) batch = false;
+    }
+    S.add(batch, "DecomposeMany", "== Decompose");
+
+    Matrix4x4 P = Matrix4x4::Identity();
+    P.At(3, 2) = -1.0; P.At(3, 3) = 0.0;
+    Vec3 t, s; Quat q;
+    S.add(P.TryDecompose(t, q, s) == MathError::NotAffine, "TryDecompose (proyectiva)", ToString(MathError::NotAffine));
+
+    // Espejo: escala x negativa, q unitario y FromTRS reconstruye la matriz
+    bool mirror = true;
+    const Matrix4x4 mirrors[2] = { Matrix4x4::Scale({ -1, 1, 1 }),
+                                   Matrix4x4::FromTRS({ 1, 2, 3 }, Quat::FromAxisAngle({ 1, 2, 3 }, 0.7), { 2, -0.5, 3 }) };
+    for (const Matrix4x4& Mm : mirrors) {
+        Mm.Decompose(t, q, s);
+        mirror = mirror && s.x < 0 && Nearly(q.s * q.s + q.x * q.x + q.y * q.y + q.z * q.z, 1.0, 1e-12)
+            && Mat4Eq(Matrix4x4::FromTRS(t, q, s), Mm, 1e-12);
+    }
+    S.add(mirror, "Decompose (espejo)", "det < 0 -> escala x negativa, FromTRS(t, q, s) == M");
+
+    // Eje con escala cero: Decompose lanza, TryDecompose y DecomposeMany tambien fallan
+    Matrix4x4 Z = Matrix4x4::Scale({ 1, 0, 1 });
+    bool thrown = false, many = false;
+    try { Z.Decompose(t, q, s); } catch (const std::runtime_error&) { thrown = true; }
+    std::vector<Matrix4x4> Zs{ Z };
+    std::vector<Vec3> zt(1), zs(1);
+    std::vector<Quat> zq(1);
+    try { Matrix4x4::DecomposeMany(Zs, zt, zq, zs); } catch (const std::runtime_error&) { many = true; }
+    S.add(thrown && many && Z.TryDecompose(t, q, s) == MathError::Singular, "Decompose (escala cero)",
+          ToString(MathError::Singular));
+}
+
+static void INV_Test_General(Suite& S) {
+    std::mt19937 g(99);
+    std::uniform_real_distribution<double> U(-3.0, 3.0);
+    const std::size_t N = 19;
+    std::vector<Matrix4x4> Ms(N), out(N), outScalar(N);
+    for (std::size_t i = 0; i < N; ++i)
+        for (int k = 0; k < 16; ++k) Ms[i].m[k] = U(g);
+
+    bool round = true;
+    for (const Matrix4x4& M : Ms)
+        if (!Mat4Eq(M.Multiply(M.Inverse()), M4_IDENTITY, 1e-9)) round = false;
+    S.add(round, "Inverse() general", "M * M^-1 == Identity");
+
+    Matrix4x4 P = Matrix4x4::Identity();
+    P.At(3, 2) = -1.0; P.At(3, 3) = 0.0; P.At(2, 3) = -0.2;
+    S.add(Mat4Eq(P.Inverse().Multiply(P), M4_IDENTITY, 1e-12), "Inverse() (proyectiva)", "No afin");
+
+    Matrix4x4 Sg = Ms[0];
+    for (int j = 0; j < 4; ++j) Sg.At(3, j) = 2.0 * Sg.At(1, j);
+    bool threw = false;
+    try { Sg.Inverse(); }
+    catch (const std::runtime_error&) { threw = true; }
+    S.add(threw && Sg.TryInverse().error == MathError::Singular, "Inverse() (singular)", "Fila dependiente");
+
+    const SimdLevel active = GetSimdLevel();
+    SetSimdLevel(SimdLevel::Scalar);
+    Matrix4x4::InverseMany(Ms, outScalar);
+    SetSimdLevel(active);
+    bool many = Matrix4x4::InverseMany(Ms, out) == MathError::None;
+    for (std::size_t i = 0; i < N; ++i)
+        if (!Mat4Eq(out[i], Ms[i].Inverse(), 1e-9) || !Mat4Eq(outScalar[i], out[i], 1e-9)) many = false;
+    S.add(many, std::string("InverseMany ") + ToString(active), "== Inverse()");
+
+    Ms[5] = Sg;
+    S.add(Matrix4x4::InverseMany(Ms, out) == MathError::Singular && Mat4Eq(out[5], Matrix4x4(), 0.0),
+        "InverseMany (una singular)", "Queda a cero");
+
+    bool trs = true;
+    std::vector<Matrix4x4> Ts(N), Ti(N);
+    for (std::size_t i = 0; i < N; ++i)
+        Ts[i] = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), 0.3 * i), { 0.5, 2.0, 1.5 });
+    Matrix4x4::InverseTRSMany(Ts, Ti);
+    for (std::size_t i = 0; i < N; ++i)
+        if (!Mat4Eq(Ti[i], Ts[i].Inverse(), 1e-9) || !Mat4Eq(Ts[i].InverseTRS(), Ti[i], 0.0)) trs = false;
+    S.add(trs, "InverseTRS / InverseTRSMany", "== Inverse()");
+}
+
+// Angulo entre dos rotaciones (acos limita la precision a ~1e-8 rad)
+static double QuatAngle(const Quat& a, const Quat& b) {
+    double d = std::fabs(a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z);
+    return 2.0 * std::acos(std::min(1.0, d));
+}
+
+static void INT_Test_Slerp(Suite& S) {
+    Vec3 u{ 1, 2, -1 };
+    Quat a{};
+    Quat b = Quat::FromAxisAngle(u, 2.0);
+    bool exact = true, fast = true, ends = true;
+    double max_err = 0.0;
+    for (int k = 0; k <= 20; ++k) {
+        double t = k / 20.0;
+        Quat ref = Quat::FromAxisAngle(u, 2.0 * t);
+        if (QuatAngle(Quat::Slerp(a, b, t), ref) > 1e-6) exact = false;
+        max_err = std::max(max_err, QuatAngle(Quat::SlerpFast(a, b, t), ref));
+    }
+    if (max_err > 1e-3) fast = false;
+    Quat nb{ -b.s, -b.x, -b.y, -b.z };
+    ends = QuatAngle(Quat::Nlerp(a, b, 0.0), a) < 1e-6 && QuatAngle(Quat::Nlerp(a, b, 1.0), b) < 1e-6
+        && QuatAngle(Quat::Slerp(a, nb, 0.5), Quat::FromAxisAngle(u, 1.0)) < 1e-6;
+    S.add(exact, "Slerp", "== FromAxisAngle(u, t*phi)");
+    S.add(ends, "Nlerp / camino corto", "Extremos y -q");
+    std::ostringstream os; os << "error max " << std::scientific << std::setprecision(2) << max_err << " rad";
+    S.add(fast, "SlerpFast", os.str());
+
+    std::mt19937 g(8);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    const std::size_t N = 37;
+    std::vector<Quat> A(N), B(N), out(N);
+    std::vector<double> T(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        A[i] = Quat::FromAxisAngle(RandUnit(g), 3.0 * U(g));
+        B[i] = Quat::FromAxisAngle(RandUnit(g), 3.0 * U(g));
+        T[i] = U(g);
+    }
+    auto check = [&](Quat(*f)(const Quat&, const Quat&, double), double tscalar) {
+        for (std::size_t i = 0; i < N; ++i) {
+            double t = (tscalar < 0) ? T[i] : tscalar;
+            Quat r = f(A[i], B[i], t);
+            if (!Nearly(r.s, out[i].s, 1e-12) || !Nearly(r.x, out[i].x, 1e-12) ||
+                !Nearly(r.y, out[i].y, 1e-12) || !Nearly(r.z, out[i].z, 1e-12)) return false;
+        }
+        return true;
+    };
+    bool many = true;
+    Quat::SlerpMany(A, B, T, out);      many = many && check(&Quat::Slerp, -1);
+    Quat::NlerpMany(A, B, T, out);      many = many && check(&Quat::Nlerp, -1);
+    Quat::SlerpFastMany(A, B, T, out);  many = many && check(&Quat::SlerpFast, -1);
+    Quat::NlerpMany(A, B, 0.3, out);    many = many && check(&Quat::Nlerp, 0.3);
+    Quat::SlerpFastMany(A, B, 0.7, out); many = many && check(&Quat::SlerpFast, 0.7);
+    S.add(many, std::string("Slerp/Nlerp/SlerpFast Many ") + ToString(GetSimdLevel()), "== version individual");
+}
+
+static void HIE_Test_Hierarchy(Suite& S) {
+    // Cadena raiz -> brazo -> mano, mas un hermano del brazo
+    TransformHierarchy H;
+    std::size_t root = H.AddNode(TransformHierarchy::NoParent, Vec3{ 1, 0, 0 }, Quat::FromAxisAngle(Vec3{ 0, 0, 1 }, PI / 2), Vec3{ 2, 2, 2 });
+    std::size_t arm = H.AddNode(root, Vec3{ 0, 1, 0 }, Quat{}, Vec3{ 1, 1, 1 });
+    std::size_t hand = H.AddNode(arm, Vec3{ 1, 0, 0 }, Quat::FromAxisAngle(Vec3{ 1, 0, 0 }, 0.3), Vec3{ 1, 1, 1 });
+    std::size_t other = H.AddNode(root);
+    std::size_t n = H.UpdateWorld();
+
+    Matrix4x4 Wroot = Matrix4x4::FromTRS(H.Translation(root), H.Rotation(root), H.Scale(root));
+    Matrix4x4 Warm = Wroot.Multiply(Matrix4x4::FromTRS(H.Translation(arm), H.Rotation(arm), H.Scale(arm)));
+    Matrix4x4 Whand = Warm.Multiply(Matrix4x4::FromTRS(H.Translation(hand), H.Rotation(hand), H.Scale(hand)));
+    S.add(n == 4 && Mat4Eq(H.World(hand), Whand) && Mat4Eq(H.World(other), Wroot),
+        "UpdateWorld", "== producto de FromTRS en cadena");
+
+    S.add(H.UpdateWorld() == 0 && !H.IsDirty(), "Escena estatica", "0 nodos recalculados");
+
+    H.SetTranslation(arm, Vec3{ 0, 3, 0 });
+    n = H.UpdateWorld();
+    Warm = Wroot.Multiply(Matrix4x4::Translate(Vec3{ 0, 3, 0 }));
+    Whand = Warm.Multiply(Matrix4x4::FromTRS(H.Translation(hand), H.Rotation(hand), H.Scale(hand)));
+    S.add(n == 2 && Mat4Eq(H.World(hand), Whand) && Mat4Eq(H.World(other), Wroot),
+        "Subarbol sucio", "Solo brazo y mano");
+
+    bool threw = false;
+    try { H.AddNode(99); }
+    catch (const std::invalid_argument&) { threw = true; }
+    S.add(threw, "Padre inexistente", "Lanza invalid_argument");
+}
+
+static void PAR_Test_Parallel(Suite& S) {
+    ThreadPool pool(4);
+    const std::size_t N = 10007;
+    std::vector<std::atomic<int>> hits(N);
+    pool.ParallelFor(N, 37, [&](std::size_t b, std::size_t e) {
+        for (std::size_t i = b; i < e; ++i) hits[i]++;
+    });
+    bool once = std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h.load() == 1; });
+    S.add(once, "ParallelFor", "Cada indice una sola vez");
+
+    std::mt19937 g(11);
+    const std::size_t M = 5003;
+    std::vector<Vec3> in(M), ref(M), out(M);
+    std::vector<double> x(M), y(M), z(M), ox(M), oy(M), oz(M), rx(M), ry(M), rz(M);
+    for (std::size_t i = 0; i < M; ++i) { in[i] = RandVec(g); x[i] = in[i].x; y[i] = in[i].y; z[i] = in[i].z; }
+    Matrix4x4 T = Matrix4x4::FromTRS(Vec3{ 1, -2, 3 }, Quat::FromAxisAngle(Vec3{ 0, 1, 0 }, 0.7), Vec3{ 2, 1, 0.5 });
+    Matrix4x4 P = T; P.At(3, 2) = -1.0; P.At(3, 3) = 4.0;
+    bool same = true;
+    for (const Matrix4x4* A : { &T, &P }) {
+        A->TransformPoints(in, ref);
+        TransformPointsParallel(*A, in, out, pool, 100);
+        for (std::size_t i = 0; i < M; ++i) same = same && ref[i].x == out[i].x && ref[i].y == out[i].y && ref[i].z == out[i].z;
+        A->TransformVectors(in, ref);
+        TransformVectorsParallel(*A, in, out, pool);
+        for (std::size_t i = 0; i < M; ++i) same = same && ref[i].x == out[i].x && ref[i].y == out[i].y && ref[i].z == out[i].z;
+        A->TransformPoints(x, y, z, rx, ry, rz);
+        TransformPointsParallel(*A, x, y, z, ox, oy, oz, pool, 64);
+        same = same && ox == rx && oy == ry && oz == rz;
+    }
+    S.add(same, "TransformPoints/VectorsParallel", "Identico a la version serie (AoS y SoA)");
+
+    bool threw = false;
+    try {
+        pool.ParallelFor(1000, 10, [](std::size_t b, std::size_t) { if (b == 500) throw std::runtime_error("x"); });
+    }
+    catch (const std::runtime_error&) { threw = true; }
+    bool size_threw = false;
+    try { TransformPointsParallel(T, in, std::span<Vec3>(out).first(10), pool); }
+    catch (const std::invalid_argument&) { size_threw = true; }
+    S.add(threw && size_threw, "Errores", "Excepcion del trozo y tamaos distintos");
+}
+
+static void DQ_Test_DualQuat(Suite& S) {
+    Quat qa = Quat::FromAxisAngle(Vec3{ 1, 2, 3 }, 0.8), qb = Quat::FromAxisAngle(Vec3{ -1, 0, 2 }, 2.1);
+    Vec3 ta{ 1, -2, 0.5 }, tb{ -3, 0, 4 };
+    DualQuat A = DualQuat::FromRotationTranslation(qa, ta), B = DualQuat::FromRotationTranslation(qb, tb);
+    Matrix4x4 MA = Matrix4x4::FromTRS(ta, qa, Vec3{ 1, 1, 1 }), MB = Matrix4x4::FromTRS(tb, qb, Vec3{ 1, 1, 1 });
+
+    DualQuat R = DualQuat::FromMatrix4x4(MA);
+    S.add(Mat4Eq(A.ToMatrix4x4(), MA) && VecEq(R.GetTranslation(), ta) && Mat4Eq(R.ToMatrix4x4(), MA),
+        "Conversiones", "FromRotationTranslation / FromMatrix4x4 / ToMatrix4x4");
+    S.add(Mat4Eq((A * B).ToMatrix4x4(), MA.Multiply(MB)), "Composicion", "== producto de matrices");
+    S.add(Mat4Eq((A * A.Inverse()).ToMatrix4x4(), M4_IDENTITY), "Inversa", "A * A^-1 = I");
+    Vec3 p{ 0.3, -1.2, 2.0 };
+    S.add(VecEq(A.TransformPoint(p), MA.TransformPoint(p)) && VecEq(A.TransformVector(p), MA.TransformVector(p)),
+        "TransformPoint/Vector", "== Matrix4x4");
+
+    // Skinning: un hueso con peso 1, el mismo hueso con -q, y mezcla 50/50 de dos giros en z
+    Vec3 z{ 0, 0, 1 };
+    DualQuat negA = A; negA.real = { -A.real.s, -A.real.x, -A.real.y, -A.real.z };
+    negA.dual = { -A.dual.s, -A.dual.x, -A.dual.y, -A.dual.z };
+    std::vector<DualQuat> pal = { A, negA, DualQuat::Identity(), DualQuat::FromRotationTranslation(Quat::FromAxisAngle(z, PI / 2), Vec3{ 0, 0, 0 }) };
+    std::vector<Vec3> pos = { p, p, Vec3{ 1, 0, 0 } }, nrm = { p, p, Vec3{ 1, 0, 0 } }, op(3), on(3);
+    std::vector<std::uint16_t> idx = { 0, 0, 0, 0, 0, 1, 0, 0, 2, 3, 0, 0 };
+    std::vector<double> w = { 1, 0, 0, 0, 0.3, 0.7, 0, 0, 0.5, 0.5, 0, 0 };
+    DualQuat::SkinMany(pal, pos, idx, w, op, nrm, on);
+    double h = std::sqrt(0.5);
+    bool skin = VecEq(op[0], MA.TransformPoint(p)) && VecEq(on[0], MA.TransformVector(p))
+        && VecEq(op[1], MA.TransformPoint(p)) && VecEq(op[2], Vec3{ h, h, 0 }) && VecEq(on[2], Vec3{ h, h, 0 });
+    S.add(skin, "SkinMany (DLB)", "Peso unico, -q y mezcla de giros");
+
+    // Vertice sin pesos: se copia sin NaN
+    std::vector<double> w0(4, 0.0);
+    std::vector<Vec3> p0 = { p }, n0 = { Vec3{ 0, 1, 0 } }, op0(1), on0(1);
+    DualQuat::SkinMany(pal, p0, std::span<const std::uint16_t>(idx).first(4), w0, op0, n0, on0);
+    S.add(VecEq(op0[0], p, 0.0) && VecEq(on0[0], n0[0], 0.0), "SkinMany pesos 0", "Vertice sin influencias -> sin cambios");
+}
+
+static void SKN_Test_Skinning(Suite& S) {
+    std::mt19937 g(13);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    const std::size_t NB = 7, N = 37;
+    std::vector<Matrix4x4> bones(NB), invBind(NB);
+    std::vector<Affine3x4> pal(NB);
+    for (std::size_t b = 0; b < NB; ++b) {
+        bones[b] = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), 3 * U(g)), Vec3{ 0.5 + U(g), 0.5 + U(g), 0.5 + U(g) });
+        invBind[b] = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), 3 * U(g)), Vec3{ 1, 1, 1 }).InverseTR();
+    }
+    Skinning::BuildPalette(bones, invBind, pal);
+    bool palOk = true;
+    for (std::size_t b = 0; b < NB; ++b) palOk = palOk && Mat4Eq(pal[b].ToMatrix4x4(), bones[b].Multiply(invBind[b]), 1e-9);
+    S.add(palOk, "BuildPalette", "bones * inverseBind");
+
+    std::vector<double> x(N), y(N), z(N), nx(N), ny(N), nz(N), w(4 * N);
+    std::vector<std::uint16_t> idx(4 * N);
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 p = RandVec(g), n = RandUnit(g);
+        x[i] = p.x; y[i] = p.y; z[i] = p.z; nx[i] = n.x; ny[i] = n.y; nz[i] = n.z;
+        double sum = 0;
+        for (int k = 0; k < 4; ++k) { idx[4 * i + k] = std::uint16_t(g() % NB); w[4 * i + k] = (k < 1 + int(i % 4)) ? U(g) : 0.0; sum += w[4 * i + k]; }
+        for (int k = 0; k < 4; ++k) w[4 * i + k] /= sum;
+    }
+    auto outs = [&] { return std::vector<std::vector<double>>(6, std::vector<double>(N)); };
+    auto targets = [](std::vector<std::vector<double>>& o) { return SkinTargets{ o[0], o[1], o[2], o[3], o[4], o[5] }; };
+    SkinStreams in{ x, y, z, nx, ny, nz, idx, w };
+
+    auto a = outs();
+    Skinning::SkinLinear(pal, in, targets(a));
+    bool ref = true;
+    for (std::size_t i = 0; i < N; ++i) {
+        Matrix4x4 B;
+        for (int k = 0; k < 4; ++k) {
+            Matrix4x4 P = pal[idx[4 * i + k]].ToMatrix4x4();
+            for (int j = 0; j < 16; ++j) B.m[j] += w[4 * i + k] * P.m[j];
+        }
+        ref = ref && VecEq(Vec3{ a[0][i], a[1][i], a[2][i] }, B.TransformPoint(Vec3{ x[i], y[i], z[i] }), 1e-9)
+            && VecEq(Vec3{ a[3][i], a[4][i], a[5][i] }, B.TransformVector(Vec3{ nx[i], ny[i], nz[i] }), 1e-9);
+    }
+    S.add(ref, std::string("SkinLinear ") + ToString(GetSimdLevel()), "== mezcla de Matrix4x4 por vertice");
+
+    SimdLevel prev = GetSimdLevel();
+    SetSimdLevel(SimdLevel::Scalar);
+    auto sc = outs();
+    Skinning::SkinLinear(pal, in, targets(sc));
+    SetSimdLevel(prev);
+    ThreadPool pool(3);
+    auto par = outs();
+    Skinning::SkinLinearParallel(pal, in, targets(par), pool, 8);
+    bool same = par == a;
+    for (int c = 0; c < 6; ++c) for (std::size_t i = 0; i < N; ++i) same = same && Nearly(sc[c][i], a[c][i], 1e-12);
+    S.add(same, "Escalar / SIMD / hilos", "Mismo resultado");
+
+    bool threw = false;
+    idx[5] = NB;
+    try { Skinning::SkinLinear(pal, in, targets(a)); }
+    catch (const std::invalid_argument&) { threw = true; }
+    S.add(threw, "Indice fuera de la paleta", "Lanza invalid_argument");
+
+    // nx no vacio pero mas corto que x: se rechaza antes de leer fuera
+    idx[5] = 0;
+    bool shortNx = false;
+    SkinStreams bad{ x, y, z, std::span<const double>(nx).first(N - 1), ny, nz, idx, w };
+    try { Skinning::SkinLinear(pal, bad, targets(a)); }
+    catch (const std::invalid_argument&) { shortNx = true; }
+    S.add(shortNx, "Normales de tamano distinto", "nx corto -> invalid_argument");
+}
+
+static void ROT_Test_RotateMany(Suite& S) {
+    std::mt19937 g(14);
+    const std::size_t N = 23;
+    Quat q = Quat::FromAxisAngle(Vec3{ 2, -1, 0.5 }, 1.3);
+    std::vector<Quat> qs(N);
+    std::vector<Vec3> in(N), out(N), small(3), small_out(3);
+    std::vector<double> x(N), y(N), z(N), ox(N), oy(N), oz(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        in[i] = RandVec(g); x[i] = in[i].x; y[i] = in[i].y; z[i] = in[i].z;
+        qs[i] = Quat::FromAxisAngle(RandUnit(g), 3.0 * RandVec(g).x);
+    }
+    for (std::size_t i = 0; i < small.size(); ++i) small[i] = in[i];
+
+    bool one = true;
+    q.RotateMany(in, out);
+    q.RotateMany(small, small_out);
+    q.RotateMany(x, y, z, ox, oy, oz);
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 r = q.Rotate(in[i]);
+        one = one && VecEq(out[i], r, 1e-12) && VecEq(Vec3{ ox[i], oy[i], oz[i] }, r, 1e-12);
+        if (i < small.size()) one = one && VecEq(small_out[i], r, 1e-12);
+    }
+    S.add(one, "RotateMany (un cuaternion)", "AoS/SoA, con y sin matriz precalculada");
+
+    bool many = true;
+    Quat::RotateMany(qs, in, out);
+    Quat::RotateMany(qs, x, y, z, ox, oy, oz);
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 r = qs[i].Rotate(in[i]);
+        many = many && VecEq(out[i], r, 1e-12) && VecEq(Vec3{ ox[i], oy[i], oz[i] }, r, 1e-12);
+    }
+    S.add(many, "RotateMany (un cuaternion por vector)", "== Rotate");
+
+    Quat::RotateMany(qs, in, in);
+    S.add(VecEq(in[5], out[5], 0.0), "RotateMany in == out", "Mismo buffer");
+}
+
+static void Q3_Test_FromMatrix(Suite& S) {
+    // Ejes y angulos que cubren las cuatro ramas (w, x, y, z dominante)
+    std::vector<Quat> ref = {
+        Quat::FromAxisAngle(Vec3{ 1, 2, 3 }, 0.4), Quat::FromAxisAngle(Vec3{ 1, 0.1, 0.2 }, 3.0),
+        Quat::FromAxisAngle(Vec3{ 0.1, 1, -0.2 }, 3.1), Quat::FromAxisAngle(Vec3{ 0.2, -0.1, 1 }, 2.9),
+        Quat::FromAxisAngle(Vec3{ 0, 0, 1 }, PI) };
+    bool ok = true;
+    for (const Quat& r : ref) {
+        Quat q = Quat::FromMatrix3x3Unchecked(r.ToMatrix3x3());
+        ok = ok && q.s >= 0 && QuatAngle(q, r) < 1e-7
+            && Nearly(q.s * q.s + q.x * q.x + q.y * q.y + q.z * q.z, 1.0, 1e-12);
+    }
+    S.add(ok, "FromMatrix3x3Unchecked", "4 ramas, unitario sin renormalizar, s >= 0");
+
+    std::mt19937 g(15);
+    const std::size_t N = 37;
+    std::vector<Matrix3x3> R(N);
+    std::vector<Quat> out(N);
+    for (std::size_t i = 0; i < N; ++i) R[i] = Quat::FromAxisAngle(RandUnit(g), 3.1 * std::fabs(RandVec(g).x)).ToMatrix3x3();
+    Quat::FromMatrix3x3ManyUnchecked(R, out);
+    bool many = true;
+    for (std::size_t i = 0; i < N; ++i) {
+        Quat q = Quat::FromMatrix3x3Unchecked(R[i]);
+        many = many && Nearly(q.s, out[i].s, 1e-15) && Nearly(q.x, out[i].x, 1e-15)
+            && Nearly(q.y, out[i].y, 1e-15) && Nearly(q.z, out[i].z, 1e-15);
+    }
+    S.add(many, std::string("FromMatrix3x3ManyUnchecked ") + ToString(GetSimdLevel()), "== version individual");
+
+    Matrix3x3 Rot = ref[0].ToMatrix3x3(), Sc = Rot, Refl = Rot, Sh = Matrix3x3::Identity();
+    for (int i = 0; i < 3; ++i) { Sc.At(i, 0) *= 1.01; Refl.At(i, 2) = -Refl.At(i, 2); }
+    Sh.At(0, 1) = 0.01;
+    S.add(Rot.IsRotation() && !Sc.IsRotation() && !Refl.IsRotation() && !Sh.IsRotation(),
+        "IsRotation", "Rechaza escala, reflexion y cizalla");
+
+    // Casi ortonormal (dentro de Tol): la version comprobada renormaliza
+    Matrix3x3f Rf = ref[0].ToMatrix3x3().Cast<float>();
+    for (int i = 0; i < 3; ++i) for (int j = 0; j < 3; ++j) Rf.At(i, j) *= 1.00002f;
+    Quatf qf = Quatf::FromMatrix3x3(Rf);
+    S.add(Rf.IsRotation() && Nearly(qf.s * qf.s + qf.x * qf.x + qf.y * qf.y + qf.z * qf.z, 1.0, 1e-6),
+        "FromMatrix3x3 (float)", "Casi ortonormal -> |q| = 1");
+}
+
+static void CAM_Test_Camera(Suite& S) {
+    const double n = 0.5, f = 100.0, fov = PI / 3, asp = 1.5;
+    Matrix4x4 P = Matrix4x4::Perspective(fov, asp, n, f);
+    double h = n * std::tan(fov / 2);
+    bool persp = VecEq(P.ProjectToNDC(Vec3{ 0, 0, -n }), Vec3{ 0, 0, -1 }, 1e-9)
+        && VecEq(P.ProjectToNDC(Vec3{ 0, 0, -f }), Vec3{ 0, 0, 1 }, 1e-9)
+        && VecEq(P.ProjectToNDC(Vec3{ h * asp, h, -n }), Vec3{ 1, 1, -1 }, 1e-9);
+    S.add(persp, "Perspective", "Near/far -> z = -1/1, borde -> x = y = 1");
+
+    Matrix4x4 O = Matrix4x4::Orthographic(-2, 4, -1, 3, 1, 11);
+    S.add(VecEq(O.ProjectToNDC(Vec3{ -2, -1, -1 }), Vec3{ -1, -1, -1 }, 1e-12)
+        && VecEq(O.ProjectToNDC(Vec3{ 4, 3, -11 }), Vec3{ 1, 1, 1 }, 1e-12), "Orthographic", "Esquinas -> +-1");
+
+    Vec3 eye{ 1, 2, 3 }, target{ 4, 2, -1 };
+    Matrix4x4 V = Matrix4x4::LookAt(eye, target, Vec3{ 0, 1, 0 });
+    bool look = VecEq(V.TransformPoint(eye), Vec3{ 0, 0, 0 }, 1e-12)
+        && VecEq(V.TransformPoint(target), Vec3{ 0, 0, -5 }, 1e-12)
+        && VecEq(V.TransformVector(Vec3{ 0, 1, 0 }), Vec3{ 0, 1, 0 }, 1e-12)
+        && Mat3Eq(V.GetRotationScale(), V.GetRotation(), 1e-12) && V.GetRotation().IsRotation();
+    S.add(look, "LookAt", "eye -> origen, target -> -Z, up -> +Y");
+
+    std::mt19937 g(16);
+    const std::size_t N = 29;
+    Matrix4x4 VP = P.Multiply(V);
+    std::vector<Vec3> in(N), out(N);
+    std::vector<double> x(N), y(N), z(N), ox(N), oy(N), oz(N), ow(N);
+    for (std::size_t i = 0; i < N; ++i) { in[i] = RandVec(g); x[i] = in[i].x; y[i] = in[i].y; z[i] = in[i].z; }
+    VP.ProjectToNDC(in, out);
+    VP.ProjectToNDC(x, y, z, ox, oy, oz, ow);
+    bool batch = true;
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 r = VP.ProjectToNDC(in[i]);
+        Vec4 c = VP.Multiply(Vec4(in[i], 1.0));
+        double e = 1e-14 * (1 + std::fabs(r.x) + std::fabs(r.y) + std::fabs(r.z));
+        batch = batch && VecEq(out[i], r, e) && VecEq(Vec3{ ox[i], oy[i], oz[i] }, r, e) && Nearly(ow[i], c.w, 1e-12)
+            && VecEq(r, Vec3{ c.x / c.w, c.y / c.w, c.z / c.w }, e);
+    }
+    S.add(batch, std::string("ProjectToNDC lote ") + ToString(GetSimdLevel()), "AoS/SoA == individual == x/w");
+
+    bool threw = false;
+    try { Matrix4x4::Perspective(fov, asp, 0.0, f); } catch (const std::invalid_argument&) { threw = true; }
+    bool threw2 = false;
+    try { Matrix4x4::LookAt(eye, Vec3{ 1, 5, 3 }, Vec3{ 0, 2, 0 }); } catch (const std::invalid_argument&) { threw2 = true; }
+    S.add(threw && threw2, "Parametros degenerados", "Lanza invalid_argument");
+}
+
+static void BND_Test_Frustum(Suite& S) {
+    Matrix4x4 VP = Matrix4x4::Perspective(PI / 3, 1.5, 0.5, 50.0)
+        .Multiply(Matrix4x4::LookAt(Vec3{ 0, 0, 5 }, Vec3{ 0, 0, 0 }, Vec3{ 0, 1, 0 }));
+    Frustum F = Frustum::FromViewProjection(VP);
+    bool planes = true;
+    for (const Plane& P : F.planes) planes = planes && Nearly(P.n.Norm(), 1.0, 1e-12);
+    planes = planes && Nearly(F.planes[Frustum::Near].Distance(Vec3{ 0, 0, 4.5 }), 0.0, 1e-12)
+        && Nearly(F.planes[Frustum::Far].Distance(Vec3{ 0, 0, -45 }), 0.0, 1e-9)
+        && Nearly(F.planes[Frustum::Near].Distance(Vec3{ 0, 0, 3.5 }), 1.0, 1e-12);
+    S.add(planes, "FromViewProjection", "Planos normalizados, near/far en su sitio");
+
+    S.add(F.Intersects(Sphere{ { 0, 0, 0 }, 1 }) && !F.Intersects(Sphere{ { 0, 0, 7 }, 1 })
+        && F.Intersects(Sphere{ { 0, 0, 5.2 }, 1 }) && F.Intersects(AABB{ { -1, -1, -1 }, { 1, 1, 1 } })
+        && !F.Intersects(AABB{ { 100, 0, 0 }, { 101, 1, 1 } }), "Intersects", "Esfera/AABB dentro, detras y al lado");
+
+    // Referencia por esquinas en coordenadas de clip: una esquina dentro -> visible;
+    // todas fuera del mismo plano -> no visible
+    std::mt19937 g(17);
+    const std::size_t N = 203;
+    std::vector<AABB> boxes(N);
+    std::vector<Sphere> spheres(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 c = RandVec(g), e = RandVec(g);
+        c = { 3 * c.x, 3 * c.y, 3 * c.z };
+        e = { 0.1 + std::fabs(e.x) / 5, 0.1 + std::fabs(e.y) / 5, 0.1 + std::fabs(e.z) / 5 };
+        boxes[i] = { { c.x - e.x, c.y - e.y, c.z - e.z }, { c.x + e.x, c.y + e.y, c.z + e.z } };
+        spheres[i] = { c, e.x };
+    }
+    std::vector<std::uint64_t> mb((N + 63) / 64, ~0ull), ms((N + 63) / 64, ~0ull);
+    std::size_t nb = F.Cull(boxes, mb), ns = F.Cull(spheres, ms);
+    bool same = true, ref = true;
+    std::size_t cb = 0, cs = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        bool vb = (mb[i / 64] >> (i % 64)) & 1, vs = (ms[i / 64] >> (i % 64)) & 1;
+        same = same && vb == F.Intersects(boxes[i]) && vs == F.Intersects(spheres[i]);
+        cb += vb; cs += vs;
+        int outside[6] = { 0 };
+        bool anyIn = false;
+        for (int k = 0; k < 8; ++k) {
+            Vec3 p{ (k & 1) ? boxes[i].max.x : boxes[i].min.x, (k & 2) ? boxes[i].max.y : boxes[i].min.y,
+                    (k & 4) ? boxes[i].max.z : boxes[i].min.z };
+            Vec4 c = VP.Multiply(Vec4(p, 1.0));
+            double cl[3] = { c.x, c.y, c.z };
+            bool in = true;
+            for (int a = 0; a < 3; ++a) {
+                if (cl[a] < -c.w) { outside[2 * a]++; in = false; }
+                if (cl[a] > c.w) { outside[2 * a + 1]++; in = false; }
+            }
+            anyIn = anyIn || in;
+        }
+        bool allOut = false;
+        for (int k = 0; k < 6; ++k) allOut = allOut || outside[k] == 8;
+        ref = ref && (!anyIn || vb) && (!allOut || !vb);
+    }
+    bool tail = (mb.back() >> (N % 64)) == 0 && (ms.back() >> (N % 64)) == 0;
+    S.add(same && tail && nb == cb && ns == cs, std::string("Cull lote ") + ToString(GetSimdLevel()),
+        std::to_string(nb) + "/" + std::to_string(N) + " AABB visibles, mascara == Intersects");
+    S.add(ref && nb > 0 && nb < N, "Cull vs esquinas", "Conservador y exacto por plano");
+
+    bool threw = false;
+    std::vector<std::uint64_t> small(1);
+    try { F.Cull(boxes, small); } catch (const std::invalid_argument&) { threw = true; }
+    S.add(threw, "Mascara pequena", "Lanza invalid_argument");
+}
+
+static void BND_Test_TransformAABB(Suite& S) {
+    std::mt19937 g(18);
+    const std::size_t N = 41;
+    std::vector<Matrix4x4> M(N);
+    std::vector<AABB> in(N), one(N), per(N), inplace;
+    bool corners = true;
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 a = RandVec(g), b = RandVec(g), s = RandVec(g);
+        M[i] = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), 2.0 * s.x / 10), Vec3{ 0.5 + std::fabs(s.y), 0.5, 0.2 + std::fabs(s.z) });
+        in[i] = { { std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z) }, { std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z) } };
+        std::vector<Vec3> c(8);
+        for (int k = 0; k < 8; ++k) {
+            c[k] = M[i].TransformPoint(Vec3{ (k & 1) ? in[i].max.x : in[i].min.x, (k & 2) ? in[i].max.y : in[i].min.y,
+                                             (k & 4) ? in[i].max.z : in[i].min.z });
+        }
+        AABB ref = AABB::FromPoints(c), r = TransformAABB(M[i], in[i]);
+        corners = corners && VecEq(r.min, ref.min, 1e-12) && VecEq(r.max, ref.max, 1e-12);
+    }
+    S.add(corners, "TransformAABB", "Centro-extension == min/max de las 8 esquinas");
+
+    AABB::TransformMany(M[0], in, one);
+    AABB::TransformMany(M, in, per);
+    inplace = in;
+    AABB::TransformMany(M, inplace, inplace);
+    bool batch = true;
+    for (std::size_t i = 0; i < N; ++i) {
+        AABB a = in[i].TransformedUnchecked(M[0]), b = in[i].TransformedUnchecked(M[i]);
+        batch = batch && VecEq(one[i].min, a.min, 1e-14) && VecEq(one[i].max, a.max, 1e-14)
+            && VecEq(per[i].min, b.min, 1e-14) && VecEq(per[i].max, b.max, 1e-14)
+            && VecEq(inplace[i].min, b.min, 1e-14) && VecEq(inplace[i].max, b.max, 1e-14);
+    }
+    S.add(batch, std::string("TransformMany ") + ToString(GetSimdLevel()), "Una matriz, una por caja e in == out");
+
+    Matrix4x4 P = Matrix4x4::Perspective(1.0, 1.0, 0.1, 10.0);
+    M[N - 1] = P;
+    bool threw = false, threw2 = false;
+    try { TransformAABB(P, in[0]); } catch (const std::runtime_error&) { threw = true; }
+    try { AABB::TransformMany(M, in, per); } catch (const std::runtime_error&) { threw2 = true; }
+    S.add(threw && threw2, "Matriz proyectiva", "Lanza runtime_error");
+}
+
+static void QNT_Test_Quantize(Suite& S) {
+    // Error maximo de rotacion sobre muchos cuaterniones aleatorios (q y -q son la misma rotacion)
+    std::mt19937 g(19);
+    double comp32 = 0, comp48 = 0, ang32 = 0, ang48 = 0;
+    bool unit = true;
+    for (int i = 0; i < 20000; ++i) {
+        Quat q = Quat::FromAxisAngle(RandUnit(g), PI * RandVec(g).x / 10);
+        Quat a = Quantize::DecodeQuat32(Quantize::EncodeQuat32(q)), b = Quantize::DecodeQuat48(Quantize::EncodeQuat48(q));
+        double sa = (a.s * q.s + a.x * q.x + a.y * q.y + a.z * q.z) < 0 ? -1 : 1;
+        double sb = (b.s * q.s + b.x * q.x + b.y * q.y + b.z * q.z) < 0 ? -1 : 1;
+        comp32 = std::max({ comp32, std::fabs(sa * a.s - q.s), std::fabs(sa * a.x - q.x), std::fabs(sa * a.y - q.y), std::fabs(sa * a.z - q.z) });
+        comp48 = std::max({ comp48, std::fabs(sb * b.s - q.s), std::fabs(sb * b.x - q.x), std::fabs(sb * b.y - q.y), std::fabs(sb * b.z - q.z) });
+        ang32 = std::max(ang32, QuatAngle(a, q));
+        ang48 = std::max(ang48, QuatAngle(b, q));
+        unit = unit && Nearly(a.s * a.s + a.x * a.x + a.y * a.y + a.z * a.z, 1.0, 1e-15);
+    }
+    std::ostringstream d;
+    d << std::setprecision(2) << "comp " << comp32 << " / " << comp48 << ", ang " << ang32 * 180 / PI << " / " << ang48 * 180 / PI << " grados";
+    S.add(unit && comp32 <= 2.1e-3 && comp48 <= 6.5e-5 && ang32 * 180 / PI <= 0.28 && ang48 * 180 / PI <= 0.009,
+        "Smallest-three 32/48 bits", d.str());
+
+    bool half = Quantize::EncodeHalf(1.0) == 0x3c00 && Quantize::EncodeHalf(-2.0) == 0xc000
+        && Quantize::EncodeHalf(65504.0) == 0x7bff && Quantize::EncodeHalf(65520.0) == 0x7c00
+        && Quantize::EncodeHalf(std::ldexp(1.0, -24)) == 0x0001 && Quantize::EncodeHalf(1.0 + std::ldexp(1.0, -11)) == 0x3c00
+        && Quantize::DecodeHalf(0x3555) == (1024 + 0x155) * std::ldexp(1.0, -12) && std::isinf(Quantize::DecodeHalf(0x7c00));
+    double rel = 0;
+    for (int i = 0; i < 10000; ++i) {
+        double x = std::ldexp(1.0 + std::fabs(RandVec(g).x) / 10, (i % 30) - 14);
+        rel = std::max(rel, std::fabs(Quantize::DecodeHalf(Quantize::EncodeHalf(x)) - x) / x);
+    }
+    S.add(half && rel <= std::ldexp(1.0, -11), "Half float", "Casos exactos y error relativo <= 2^-11");
+
+    bool fixed = Quantize::EncodeFixed16(-5.0, -4.0, 4.0) == 0 && Quantize::EncodeFixed16(9.0, -4.0, 4.0) == 65535;
+    for (int i = 0; i < 1000; ++i) {
+        double x = RandVec(g).x * 0.4;
+        fixed = fixed && std::fabs(Quantize::DecodeFixed16(Quantize::EncodeFixed16(x, -4.0, 4.0), -4.0, 4.0) - x) <= 8.0 / 131070 * (1 + 1e-9);
+    }
+    S.add(fixed, "Punto fijo 16 bits", "Error <= rango / 131070, satura fuera");
+
+    // Transformaciones completas y lote == individual
+    const AABB range{ { -20, -20, -20 }, { 20, 20, 20 } };
+    const std::size_t N = 67;
+    std::vector<Matrix4x4> M(N), D32(N), D48(N);
+    std::vector<PackedTransform32> P32(N);
+    std::vector<PackedTransform48> P48(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        Vec3 sc = RandVec(g);
+        M[i] = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), PI * sc.x / 10),
+            Vec3{ 0.5 + std::fabs(sc.y) / 5, 1.0, 0.25 + std::fabs(sc.z) / 5 });
+    }
+    Quantize::EncodeMany(M, range, P32);
+    Quantize::EncodeMany(M, range, P48);
+    Quantize::DecodeMany(P32, range, D32);
+    Quantize::DecodeMany(P48, range, D48);
+    bool same = true;
+    double err32 = 0, err48 = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        PackedTransform32 a; PackedTransform48 b;
+        Quantize::Encode(M[i], range, a);
+        Quantize::Encode(M[i], range, b);
+        same = same && std::memcmp(&a, &P32[i], sizeof a) == 0 && std::memcmp(&b, &P48[i], sizeof b) == 0
+            && Mat4Eq(Quantize::Decode(a, range), D32[i], 0.0) && Mat4Eq(Quantize::Decode(b, range), D48[i], 0.0);
+        for (int k = 0; k < 16; ++k) {
+            err32 = std::max(err32, std::fabs(D32[i].m[k] - M[i].m[k]));
+            err48 = std::max(err48, std::fabs(D48[i].m[k] - M[i].m[k]));
+        }
+    }
+    std::ostringstream e;
+    e << std::setprecision(2) << "error max matriz " << err32 << " / " << err48 << (same ? "" : " DISTINTO");
+    S.add(same && err32 < 2e-2 && err48 < 2e-3, std::string("Encode/DecodeMany ") + ToString(GetSimdLevel()), e.str());
+    S.add(sizeof(PackedTransform32) == 16 && sizeof(PackedTransform48) == 18, "Tamano", "128 bytes -> 16 / 18 (8x / 7.1x)");
+
+    bool threw = false, threw2 = false;
+    try { Quantize::EncodeMany(M, AABB{ { 0, 0, 0 }, { 1, 0, 1 } }, P32); } catch (const std::invalid_argument&) { threw = true; }
+    M[3].At(3, 0) = 0.5;
+    try { Quantize::EncodeMany(M, range, P48); } catch (const std::runtime_error&) { threw2 = true; }
+    S.add(threw && threw2, "Rango vacio / no afin", "Lanza invalid_argument / runtime_error");
+
+    // Escala nula: la misma validacion que Decompose (CheckDecompose)
+    bool threw3 = false;
+    M[3] = Matrix4x4::Scale({ 1, 0, 1 });
+    try { Quantize::EncodeMany(M, range, P32); } catch (const std::runtime_error&) { threw3 = true; }
+    S.add(threw3 && M[3].CheckDecompose() == MathError::Singular && M[2].CheckDecompose() == MathError::None,
+        "Escala nula", "CheckDecompose -> Singular, EncodeMany lanza runtime_error");
+}
+
+static void STR_Test_Stream(Suite& S) {
+    namespace fs = std::filesystem;
+    const std::string path = (fs::temp_directory_path() / "lab3_stream_test.l3ts").string();
+    std::mt19937 g(20);
+    const std::size_t N = 1000;
+    std::vector<Matrix4x4> M(N);
+    std::vector<TRSRecord> trs(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        trs[i] = { RandVec(g), Quat::FromAxisAngle(RandUnit(g), 0.3 * RandVec(g).x), Vec3{ 1, 2, 3 } };
+        M[i] = Matrix4x4::FromTRS(trs[i].t, trs[i].q, trs[i].s);
+    }
+
+    {
+        // Escritura en dos trozos y un registro suelto
+        TransformStreamWriter<Matrix4x4> w(path);
+        w.Write(std::span<const Matrix4x4>(M).first(600));
+        w.Write(std::span<const Matrix4x4>(M).subspan(600, N - 601));
+        w.Write(M.back());
+        w.Close();
+    }
+    bool round = false, aligned = false, kernel = false;
+    {
+        TransformStreamReader<Matrix4x4> r(path);
+        std::span<const Matrix4x4> rec = r.Records();
+        round = rec.size() == N && std::memcmp(rec.data(), M.data(), N * sizeof(Matrix4x4)) == 0 && r.VerifyChecksum();
+        aligned = reinterpret_cast<std::uintptr_t>(rec.data()) % 64 == 0;
+        // El span alimenta directamente un kernel en lote
+        std::vector<Matrix4x4> inv(N);
+        Matrix4x4::InverseTRSMany(rec, inv);
+        kernel = Mat4Eq(M[7].Multiply(inv[7]), Matrix4x4::Identity(), 1e-12);
+    }
+    S.add(round && aligned, "Matrix4x4 ida y vuelta", "Escritura por trozos, lectura mmap sin copia, datos alineados a 64");
+    S.add(kernel, "Span en kernel en lote", "InverseTRSMany sobre el mapeo");
+
+    bool trsOk = false;
+    {
+        TransformStreamWriter<TRSRecord> w(path);
+        w.Write(trs);
+    }
+    {
+        TransformStreamReader<TRSRecord> r(path);
+        trsOk = r.Size() == N && std::memcmp(r.Records().data(), trs.data(), N * sizeof(TRSRecord)) == 0;
+    }
+    S.add(trsOk, "TRSRecord", "El destructor del escritor cierra el fichero");
+
+    // Un byte corrupto en los datos, otro tipo de registro, offset de datos
+    // distinto de 64 y fichero truncado
+    bool corrupt = false, wrongType = false, badOffset = false, truncated = false;
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(64 + 5 * sizeof(TRSRecord) + 3);
+        f.put(char(0x5a));
+    }
+    try { TransformStreamReader<TRSRecord> r(path); } catch (const std::runtime_error&) { corrupt = true; }
+    try { TransformStreamReader<Quat> r(path, false); } catch (const std::runtime_error&) { wrongType = true; }
+    {
+        // dataOffset esta en el byte 32 de la cabecera
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        const std::uint64_t zero = 0;
+        f.seekp(32);
+        f.write(reinterpret_cast<const char*>(&zero), sizeof zero);
+    }
+    try { TransformStreamReader<TRSRecord> r(path, false); } catch (const std::runtime_error&) { badOffset = true; }
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        const std::uint64_t off = 64;
+        f.seekp(32);
+        f.write(reinterpret_cast<const char*>(&off), sizeof off);
+    }
+    fs::resize_file(path, 64 + 10 * sizeof(TRSRecord));
+    try { TransformStreamReader<TRSRecord> r(path, false); } catch (const std::runtime_error&) { truncated = true; }
+    fs::remove(path);
+    S.add(corrupt && wrongType && badOffset && truncated, "Validacion", "Checksum, tipo, offset y tamano -> runtime_error");
+}
+
+// -------------------- constexpr ----------------------------
+
+// Tablas resueltas en compilacion: cambio de ejes Y-up -> Z-up y un modelo T * S
+static constexpr Matrix3x3 CEX_YUP_TO_ZUP = { 1, 0, 0,
+                                              0, 0, -1,
+                                              0, 1, 0 };
+static constexpr Matrix4x4 CEX_MODEL = Matrix4x4::Translate({ 1, 2, 3 }).Multiply(Matrix4x4::Scale({ 2, 2, 2 }));
+static constexpr Quat CEX_Q = Quat{ 0, 1, 0, 0 } * Quat{ 0, 0, 1, 0 };
+
+static_assert(M4_IDENTITY.At(2, 2) == 1 && M4_IDENTITY.At(2, 3) == 0);
+static_assert(CEX_MODEL.At(0, 0) == 2 && CEX_MODEL.At(1, 3) == 2 && CEX_MODEL.At(3, 3) == 1);
+static_assert(CEX_YUP_TO_ZUP.Multiply(CEX_YUP_TO_ZUP.Transposed()).Trace() == 3);
+static_assert((CEX_YUP_TO_ZUP * Vec3{ 0, 1, 0 }).z == 1);
+static_assert(Vec3::Cross({ 1, 0, 0 }, { 0, 1, 0 }).z == 1 && Vec3::Dot({ 1, 2, 3 }, { 4, 5, 6 }) == 32);
+static_assert(CEX_Q.s == 0 && CEX_Q.z == 1);   // i * j = k
+
+// Producto con entradas no enteras: hay redondeo en cada termino
+static constexpr Matrix4x4 CEX_A = Matrix4x4::Translate({ 0.1, -0.7, 1.3 }).Multiply(Matrix4x4::Scale({ 1.0 / 3, 0.3, 2.7 }));
+static constexpr Matrix4x4 CEX_B = [] {
+    Matrix4x4 B;
+    for (int k = 0; k < 16; ++k) B.m[k] = 0.1 * (k + 1) - 1.0 / 7;
+    return B;
+}();
+static constexpr Matrix4x4 CEX_AB = CEX_A.Multiply(CEX_B);
+
+static void CEX_Test_Constexpr(Suite& S) {
+    std::mt19937 rng(21);
+    // El producto en compilacion (escalar) y en ejecucion (kernel SIMD) coinciden
+    Matrix4x4 T = Matrix4x4::Translate({ 1, 2, 3 }), Sc = Matrix4x4::Scale({ 2, 2, 2 });
+    S.add(Mat4Eq(T.Multiply(Sc), CEX_MODEL, 0.0), "Translate * Scale", "constexpr == runtime");
+
+    bool same = true;
+    for (int i = 0; i < 50; ++i) {
+        Matrix4x4 A = Matrix4x4::FromTRS(RandVec(rng), Quat::FromAxisAngle(RandUnit(rng), 0.1 * i), { 1, 1, 1 });
+        Matrix4x4 Ar = A.Multiply(Matrix4x4::Rotate(CEX_YUP_TO_ZUP));
+        Matrix4x4 Aa = A.MultiplyAffine(Matrix4x4::Rotate(CEX_YUP_TO_ZUP));
+        same = same && Mat4Eq(Ar, Aa, 1e-12);
+    }
+    S.add(same, "Tabla de ejes", "Rotate(Matrix3x3 constexpr) en producto general y afin");
+
+    // Entradas no enteras: igual bit a bit hasta AVX2; con FMA, a un ulp
+    const SimdLevel active = GetSimdLevel();
+    bool exact = true, nearFma = true;
+    for (SimdLevel l : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::FMA }) {
+        if (l > DetectSimdLevel()) break;
+        SetSimdLevel(l);
+        Matrix4x4 AB = CEX_A.Multiply(CEX_B);
+        if (l == SimdLevel::FMA) nearFma = Mat4Eq(AB, CEX_AB, 1e-14);
+        else exact = exact && Mat4Eq(AB, CEX_AB, 0.0);
+    }
+    SetSimdLevel(active);
+    S.add(exact && nearFma, "Entradas no enteras", "constexpr == runtime (exacto sin FMA, 1e-14 con FMA)");
+}
+
+// -------------------- Expresiones perezosas ----------------------------
+
+static constexpr Matrix3x3 EXP_SWAP = { 0, 1, 0,
+                                        1, 0, 0,
+                                        0, 0, 1 };
+static_assert((EXP_SWAP * EXP_SWAP * Vec3{ 1, 2, 3 }).y == 2);
+static_assert(Matrix3x3(EXP_SWAP * EXP_SWAP * EXP_SWAP).At(0, 1) == 1);
+
+static Matrix4x4 EXP_Make(double k) { return Matrix4x4::Scale({ k, k, k }); }
+
+template <typename T>
+static T EXP_Det(const Matrix3x3T<T>& M) { return M.Det(); }
+
+static void EXP_Test_Chain(Suite& S) {
+    std::mt19937 g(22);
+    bool mat4 = true, vec4 = true, mat3 = true, vec3 = true;
+    for (int i = 0; i < 100; ++i) {
+        Matrix4x4 T = Matrix4x4::Translate(RandVec(g));
+        Matrix4x4 R = Matrix4x4::Rotate(Quat::FromAxisAngle(RandUnit(g), 0.1 * i));
+        Matrix4x4 Sc = Matrix4x4::Scale({ 0.5 + 0.01 * i, 2.0, 1.5 });
+        Matrix4x4 P = Matrix4x4::Perspective(1.2, 1.5, 0.1, 100.0);
+        Vec4 v(RandVec(g), 1.0);
+
+        // Como matriz: mismos productos y mismo orden que la cadena explicita
+        Matrix4x4 M = P * T * R * Sc;
+        Matrix4x4 ref = P.Multiply(T).Multiply(R).Multiply(Sc);
+        mat4 = mat4 && Mat4Eq(M, ref, 0.0);
+
+        // Por un vector: de derecha a izquierda, sin matrices intermedias
+        Vec4 a = P * T * R * Sc * v;
+        Vec4 b = P.Multiply(T.Multiply(R.Multiply(Sc.Multiply(v))));
+        Vec4 c = ref.Multiply(v);
+        vec4 = vec4 && a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w
+            && Nearly(a.x, c.x, 1e-9) && Nearly(a.y, c.y, 1e-9) && Nearly(a.z, c.z, 1e-9) && Nearly(a.w, c.w, 1e-9);
+
+        Matrix3x3 A = Quat::FromAxisAngle(RandUnit(g), 0.2 * i).ToMatrix3x3();
+        Matrix3x3 B = Matrix3x3::FromEulerZYX(0.1 * i, 0.2, -0.3);
+        Matrix3x3 AB = A * B * EXP_SWAP;
+        mat3 = mat3 && Mat3Eq(AB, A.Multiply(B).Multiply(EXP_SWAP), 0.0);
+        Vec3 w = RandVec(g);
+        vec3 = vec3 && VecEq(A * B * EXP_SWAP * w, A.Multiply(B.Multiply(EXP_SWAP.Multiply(w))), 0.0);
+    }
+    S.add(mat4, "Matrix4x4 P*T*R*S", "Conversion a matriz == Multiply encadenado (exacto)");
+    S.add(vec4, "Matrix4x4 P*T*R*S*v", "Producto matriz-vector de derecha a izquierda");
+    S.add(mat3 && vec3, "Matrix3x3", "Cadenas de matrices y por vector");
+
+    // Operandos temporales: el nodo los guarda por valor y sobrevive a la
+    // sentencia (con -fsanitize=address una referencia colgante se detecta)
+    Matrix4x4 A = Matrix4x4::Translate({ 1, 2, 3 });
+    auto E = A * EXP_Make(3.0);
+    auto F = EXP_Make(2.0) * E * EXP_Make(0.5);
+    Matrix4x4 r = E, q = F;
+    Vec4 fv = F * Vec4(1, 1, 1, 1);
+    S.add(Mat4Eq(r, A.Multiply(EXP_Make(3.0)), 0.0) && Mat4Eq(q, EXP_Make(2.0).Multiply(r).Multiply(EXP_Make(0.5)), 0.0)
+        && Nearly(fv.x, 5.0, 1e-12) && Nearly(fv.w, 1.0, 1e-12), "Temporales", "auto E = A * Make(k) sin referencias colgantes");
+
+    // El producto de dos matrices se usa como la matriz resultante
+    Matrix3x3 R3 = Matrix3x3::FromEulerZYX(0.3, -0.2, 0.1);
+    Matrix3x3 D3 = R3 * EXP_SWAP;
+    S.add(Nearly((R3 * EXP_SWAP).Det(), D3.Det(), 0.0) && (R3 * EXP_SWAP).At(1, 2) == D3.At(1, 2)
+        && Mat3Eq((R3 * EXP_SWAP).Transposed(), D3.Transposed(), 0.0) && Nearly((A * A).Det(), 1.0, 1e-12)
+        && EXP_Det((R3 * EXP_SWAP).Eval()) == D3.Det(), "Miembros", "(A*B).Det(), At, Transposed, Eval()");
+}
+
+// -------------------- Transform ----------------------------
+
+static void TRF_Test_Transform(Suite& S) {
+    std::mt19937 g(23);
+    bool exact = true, inverse = true, lazy = true;
+    Transform X;
+    for (int i = 0; i < 100; ++i) {
+        const Vec3 t = RandVec(g), s{ 0.5 + 0.01 * i, 2.0, 1.5 };
+        const Quat q = Quat::FromAxisAngle(RandUnit(g), 0.1 * i);
+        const std::uint64_t v0 = X.Version();
+        X.SetTranslation(t); X.SetRotation(q); X.SetScale(s);
+        lazy = lazy && X.Version() == v0 + 3;
+
+        const Matrix4x4& M = X.Matrix();
+        exact = exact && Mat4Eq(M, Matrix4x4::FromTRS(t, q, s), 0.0);
+        // Sin cambios la lectura devuelve la misma cache
+        lazy = lazy && &X.Matrix() == &M && X.Version() == v0 + 3;
+
+        inverse = inverse && Mat4Eq(X.Inverse(), M.InverseTRS(), 1e-12)
+            && Mat4Eq(M.Multiply(X.Inverse()), M4_IDENTITY, 1e-12);
+    }
+    S.add(exact, "Matrix()", "== FromTRS(t, q, s)");
+    S.add(inverse, "Inverse()", "== InverseTRS, M * M^-1 = I");
+    S.add(lazy, "Version", "Un incremento por setter, lectura sin recalculo");
+
+    // Ediciones repetidas: Transform no acumula error; Matrix4x4 redescompone en cada setter
+    Matrix4x4 A = Matrix4x4::FromTRS({ 1, 2, 3 }, Quat::FromAxisAngle({ 0, 1, 0 }, 0.7), { 3, 0.5, 2 });
+    Transform B({ 1, 2, 3 }, Quat::FromAxisAngle({ 0, 1, 0 }, 0.7), { 3, 0.5, 2 });
+    for (int i = 0; i < 1000; ++i) {
+        const Vec3 s{ 3.0 + 1e-3 * (i % 7), 0.5, 2.0 };
+        A.SetScale(s); A.SetTranslation({ 1, 2, 3 });
+        B.SetScale(s); B.SetTranslation({ 1, 2, 3 });
+    }
+    const Vec3 sEnd{ 3.0 + 1e-3 * (999 % 7), 0.5, 2.0 };
+    const Matrix4x4 ref = Matrix4x4::FromTRS({ 1, 2, 3 }, Quat::FromAxisAngle({ 0, 1, 0 }, 0.7), sEnd);
+    S.add(Mat4Eq(B.Matrix(), ref, 0.0) && Mat4Eq(A, ref, 1e-9), "Sin deriva", "1000 ediciones == construccion directa");
+
+    // Desde matriz y rotacion invalida
+    Transform C = Transform::FromMatrix(ref);
+    bool thrown = false;
+    Matrix3x3 notRot = Matrix3x3::Identity();
+    notRot.At(0, 0) = 2;
+    try { C.SetRotation(notRot); } catch (const std::invalid_argument&) { thrown = true; }
+    S.add(Mat4Eq(C.Matrix(), ref, 1e-12) && thrown, "FromMatrix / SetRotation(Matrix3x3)", "Descompone una vez; no rotacion -> invalid_argument");
+
+    // Espejo: la escala x negativa absorbe la reflexion y q sigue unitario
+    bool mirror = true;
+    for (const Matrix4x4& Mm : { Matrix4x4::Scale({ -1, 1, 1 }), Matrix4x4::FromTRS({ 1, 0, -2 }, Quat::FromAxisAngle({ 1, 1, 0 }, 0.9), { 2, -3, 0.5 }) }) {
+        Transform Xm = Transform::FromMatrix(Mm);
+        const Quat& qm = Xm.Rotation();
+        mirror = mirror && Mat4Eq(Xm.Matrix(), Mm, 1e-12) && Xm.Scale().x < 0
+            && Nearly(qm.s * qm.s + qm.x * qm.x + qm.y * qm.y + qm.z * qm.z, 1.0, 1e-12);
+    }
+    S.add(mirror, "FromMatrix (espejo)", "Scale({-1,1,1}) -> Matrix() == entrada, |q| = 1");
+}
+
+// -------------------- Normales ----------------------------
+
+static void NRM_Test_Normals(Suite& S) {
+    std::mt19937 g(24);
+    auto unit = [](const Vec3& v) { return v.Normalize(); };
+    bool prop = true, exact = true, perp = true, mirror = true;
+    for (int i = 0; i < 100; ++i) {
+        const Vec3 s{ 0.2 + 0.05 * i, (i % 3 == 0) ? -1.5 : 3.0, 0.7 };
+        Matrix4x4 M = Matrix4x4::FromTRS(RandVec(g), Quat::FromAxisAngle(RandUnit(g), 0.1 * i), s);
+        const Matrix3x3 ref = M.InverseTRS().GetRotationScaleUnchecked().Transposed();
+        const Matrix3x3 N = M.NormalMatrix(), E = M.NormalMatrixExact();
+        exact = exact && Mat3Eq(E, ref, 1e-12);
+
+        // Misma direccion que (M^-1)^T, y sentido conservado aun con espejo
+        const Vec3 n = RandUnit(g);
+        prop = prop && VecEq(unit(N * n), unit(E * n), 1e-12);
+        mirror = mirror && Vec3::Dot(N * n, E * n) > 0;
+
+        // Un vector tangente sigue perpendicular a la normal transformada
+        const Vec3 t = unit(Vec3::Cross(n, RandUnit(g)));
+        perp = perp && std::fabs(Vec3::Dot(unit(M.TransformVector(t)), unit(N * n))) < 1e-12;
+    }
+    S.add(exact, "NormalMatrixExact", "== InverseTRS()^T (3x3)");
+    S.add(prop && mirror, "NormalMatrix", "Cofactores: misma direccion y sentido (tambien con escala negativa)");
+    S.add(perp, "Perpendicularidad", "Escala no uniforme: tangente . normal = 0");
+
+    Matrix4x4 P = Matrix4x4::Perspective(1.0, 1.5, 0.1, 10.0);
+    Matrix4x4 Z = Matrix4x4::Scale({ 1, 0, 1 });
+    bool thrown = false, singular = false;
+    try { P.NormalMatrix(); } catch (const std::runtime_error&) { thrown = true; }
+    try { Z.NormalMatrixExact(); } catch (const std::runtime_error&) { singular = true; }
+    S.add(thrown && singular, "Errores", "No afin / singular -> runtime_error");
+
+    // Lote AoS y SoA (n impar para el resto escalar) frente a la referencia
+    const std::size_t n = 1001;
+    Matrix4x4 M = Matrix4x4::FromTRS({ 1, 2, 3 }, Quat::FromAxisAngle({ 1, 2, 0.5 }, 0.9), { 0.5, 4.0, -2.0 });
+    const Matrix3x3 N = M.NormalMatrix();
+    std::vector<Vec3> in(n), out(n);
+    std::vector<double> x(n), y(n), z(n), ox(n), oy(n), oz(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        in[i] = (i == 17) ? Vec3{ 0, 0, 0 } : RandVec(g);
+        x[i] = in[i].x; y[i] = in[i].y; z[i] = in[i].z;
+    }
+    M.TransformNormals(in, out);
+    M.TransformNormals(x, y, z, ox, oy, oz);
+    bool aos = true, soa = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Vec3 r = (i == 17) ? Vec3{ 0, 0, 0 } : unit(N * in[i]);
+        aos = aos && VecEq(out[i], r, 1e-12) && (i == 17 || Nearly(out[i].Norm(), 1.0, 1e-12));
+        soa = soa && VecEq({ ox[i], oy[i], oz[i] }, r, 1e-12);
+    }
+    std::vector<Vec3> inplace = in;
+    M.TransformNormals(inplace, inplace);
+    aos = aos && std::memcmp(inplace.data(), out.data(), n * sizeof(Vec3)) == 0;
+    S.add(aos && soa, "TransformNormals", "AoS/SoA/in situ == N * n / |N * n|; normal nula -> 0");
+
+    std::vector<Vec3f> inf(n), outf(n);
+    for (std::size_t i = 0; i < n; ++i) inf[i] = in[i].Cast<float>();
+    M.Cast<float>().TransformNormals(inf, outf);
+    bool f32 = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i == 17) { f32 = f32 && outf[i].x == 0 && outf[i].y == 0 && outf[i].z == 0; continue; }
+        f32 = f32 && Nearly(outf[i].Norm(), 1.0, 1e-6) && VecEq(outf[i].Cast<double>(), out[i], 1e-5);
+    }
+    S.add(f32, "TransformNormals float", "|n| - 1 <= 1e-6 con rsqrt");
+
+    // La cache del componente se invalida con la version
+    Transform X({ 1, 2, 3 }, Quat::FromAxisAngle({ 0, 0, 1 }, 0.3), { 1, 2, 3 });
+    const Matrix3x3 N0 = X.NormalMatrix();
+    X.SetScale({ 2, 2, 2 });
+    S.add(Mat3Eq(N0, X.Matrix().NormalMatrix(), 1e-12) == false && Mat3Eq(X.NormalMatrix(), X.Matrix().NormalMatrix(), 0.0),
+          "Transform::NormalMatrix", "Se recalcula tras SetScale");
+}
+
+// -------------------- Arena ----------------------------
+
+static bool Aligned64(const void* p) { return reinterpret_cast<std::uintptr_t>(p) % 64 == 0; }
+
+static void ARN_Test_Arena(Suite& S) {
+    std::mt19937 g(25);
+    FrameArena arena(1 << 16);
+
+    // Alineacion de todos los arrays y memoria reutilizada tras Reset
+    const std::size_t n = 37;
+    Vec3SoA P = Vec3SoA::Allocate(arena, n);
+    QuatSoA Q = QuatSoA::Allocate(arena, n);
+    std::span<Matrix4x4> mats = arena.AllocateArray<Matrix4x4>(n);
+    bool aligned = Aligned64(P.x.data()) && Aligned64(P.y.data()) && Aligned64(P.z.data())
+        && Aligned64(Q.s.data()) && Aligned64(Q.z.data()) && Aligned64(mats.data());
+    bool init = std::all_of(mats.begin(), mats.end(), [](const Matrix4x4& M) { return Mat4Eq(M, Matrix4x4(), 0.0); });
+    const void* first = P.x.data();
+    arena.Reset();
+    Vec3SoA P2 = Vec3SoA::Allocate(arena, n);
+    S.add(aligned && init && P2.x.data() == first && arena.BlockCount() == 1, "Alineacion y Reset",
+          "Arrays a 64 bytes, construidos por defecto; Reset reutiliza el bloque");
+
+    // Un frame que no cabe encadena bloques; el Reset los fusiona y el siguiente frame no crece
+    Matrix4x4SoA M = Matrix4x4SoA::Allocate(arena, 1000);
+    const std::size_t blocks = arena.BlockCount(), used = arena.Used();
+    arena.Reset();
+    const std::size_t cap = arena.Capacity();
+    Matrix4x4SoA M2 = Matrix4x4SoA::Allocate(arena, 1000);
+    bool grow = Aligned64(M.m[15].data()) && blocks > 1 && used >= 16 * 1000 * sizeof(double) && arena.BlockCount() == 1
+        && arena.Capacity() == cap && Aligned64(M2.m[15].data());
+    S.add(grow, "Crecimiento", "Bloques encadenados y fusionados en el Reset");
+
+    // Ida y vuelta AoS <-> SoA y kernels SoA sobre los arrays de la arena
+    arena.Reset();
+    const std::size_t N = 501;
+    std::vector<Matrix4x4> Ms(N), back(N);
+    std::vector<Vec3> pts(N), ref(N), got(N);
+    std::vector<Quat> qs(N), qback(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        qs[i] = Quat::FromAxisAngle(RandUnit(g), 0.01 * double(i));
+        Ms[i] = Matrix4x4::FromTRS(RandVec(g), qs[i], { 1, 2, 3 });
+        pts[i] = RandVec(g);
+    }
+    Matrix4x4SoA MS = Matrix4x4SoA::Allocate(arena, N);
+    QuatSoA QS = QuatSoA::Allocate(arena, N);
+    Vec3SoA V = Vec3SoA::Allocate(arena, N), W = Vec3SoA::Allocate(arena, N);
+    MS.Load(Ms); MS.Store(back);
+    QS.Load(qs); QS.Store(qback);
+    V.Load(pts);
+    bool round = std::memcmp(back.data(), Ms.data(), N * sizeof(Matrix4x4)) == 0
+        && std::memcmp(qback.data(), qs.data(), N * sizeof(Quat)) == 0 && Mat4Eq(MS.Get(7), Ms[7], 0.0);
+
+    Ms[3].TransformPoints(pts, ref);
+    Ms[3].TransformPoints(V.x, V.y, V.z, W.x, W.y, W.z);
+    W.Store(got);
+    bool kernel = true;
+    for (std::size_t i = 0; i < N; ++i) kernel = kernel && VecEq(got[i], ref[i], 1e-12);
+    S.add(round && kernel, "SoA", "Load/Store exactos; TransformPoints SoA sobre la arena");
+
+    bool badAlign = false, badSize = false;
+    try { arena.Allocate(8, 3); } catch (const std::invalid_argument&) { badAlign = true; }
+    try { V.Store(std::span<Vec3>(got).first(10)); } catch (const std::invalid_argument&) { badSize = true; }
+    S.add(badAlign && badSize, "Errores", "Alineacion no potencia de 2 / tamanos distintos -> invalid_argument");
+}
+
 // -------------------- Main -----------------------------
 int main() {
     std::cout << BOLD << CYAN << "Test Bench Lab 3 (Final)" << RESET << "\n";
@@ -210,6 +1437,29 @@ int main() {
     { Suite S("[Ex1] Transformaciones Basicas"); EX1_Test_IsAffine(S); EX1_Test_Constructors(S); EX1_Test_PointVsVector(S); RUN(S); }
     { Suite S("[Ex2] Inversas (TR)"); EX2_Test_Inverses(S); RUN(S); }
     { Suite S("[Ex3] Descomposicion (Helpers)"); EX3_Test_Decomposition(S); RUN(S); }
+    { Suite S("[Lot] Transformaciones en lote"); LOT_Test_TransformBatch(S); RUN(S); }
+    { Suite S("[SIMD] Producto 4x4"); SIMD_Test_Multiply(S); RUN(S); }
+    { Suite S("[Afin] Affine3x4"); AFF_Test_Affine3x4(S); RUN(S); }
+    { Suite S("[Float] Instancias float"); F32_Test_Float(S); RUN(S); }
+    { Suite S("[Rapido] Getters/Setters sin validacion"); CHK_Test_Unchecked(S); RUN(S); }
+    { Suite S("[Desc] Descomposicion TRS"); DEC_Test_Decompose(S); RUN(S); }
+    { Suite S("[Inv] Inversa general"); INV_Test_General(S); RUN(S); }
+    { Suite S("[Interp] Slerp / Nlerp"); INT_Test_Slerp(S); RUN(S); }
+    { Suite S("[Jerarquia] Transformaciones padre/hijo"); HIE_Test_Hierarchy(S); RUN(S); }
+    { Suite S("[Hilos] Transformaciones en paralelo"); PAR_Test_Parallel(S); RUN(S); }
+    { Suite S("[DQ] Cuaterniones duales"); DQ_Test_DualQuat(S); RUN(S); }
+    { Suite S("[Skin] Skinning lineal"); SKN_Test_Skinning(S); RUN(S); }
+    { Suite S("[Rot] Rotacion en lote"); ROT_Test_RotateMany(S); RUN(S); }
+    { Suite S("[Q3] Quat desde Matrix3x3"); Q3_Test_FromMatrix(S); RUN(S); }
+    { Suite S("[Camara] Proyeccion y LookAt"); CAM_Test_Camera(S); RUN(S); }
+    { Suite S("[Bounds] Frustum culling y AABB"); BND_Test_Frustum(S); BND_Test_TransformAABB(S); RUN(S); }
+    { Suite S("[Quant] Transformaciones comprimidas"); QNT_Test_Quantize(S); RUN(S); }
+    { Suite S("[Stream] Ficheros binarios mapeados"); STR_Test_Stream(S); RUN(S); }
+    { Suite S("[Constexpr] Nucleo en compilacion"); CEX_Test_Constexpr(S); RUN(S); }
+    { Suite S("[Expr] Productos encadenados perezosos"); EXP_Test_Chain(S); RUN(S); }
+    { Suite S("[Transform] Componente TRS con cache"); TRF_Test_Transform(S); RUN(S); }
+    { Suite S("[Normales] Matriz de normales"); NRM_Test_Normals(S); RUN(S); }
+    { Suite S("[Arena] Buffers por frame"); ARN_Test_Arena(S); RUN(S); }
 
     std::cout << "\n" << ((suites_ok == total_suites) ? GREEN : RED)
         << "Resultado Global: " << suites_ok << "/" << total_suites << " suites OK" << RESET << "\n";
@@ -0,0 +1,730 @@
+// Microbenchmarks de rendimiento (estilo Google Benchmark, sin dependencias).
+// Mide ns/op, throughput y desviacion de las funciones publicas de Matrix3x3,
+// Matrix4x4 y Quat, llamada individual y en lote.
+//
+//   g++ -std=c++20 -O2 -Iinclude src/*.cpp bench/perf.cpp -o perf -lpthread
+//   ./perf [--json | --csv] [--filter=texto] [--min-time=ms] [--reps=N] [--simd=scalar|sse2|avx2|fma]
+//          [--threads=N]
+//
+// Con --json o --csv la salida es apta para comparar entre commits.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Bounds.hpp"
+#include "DualQuat.hpp"
+#include "FrameArena.hpp"
+#include "Matrix4x4.hpp"
+#include "ParallelTransform.hpp"
+#include "Quantize.hpp"
+#include "Quat.hpp"
+#include "Simd.hpp"
+#include "Skinning.hpp"
+#include "Transform.hpp"
+#include "TransformStream.hpp"
+
+// -------------------- Anti-optimizacion ------------------
+template <typename V>
+static inline void DoNotOptimize(const V& v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&v) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &v;
+#endif
+}
+
+static inline void ClobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// -------------------- Registro de casos ------------------
+// Cada caso ejecuta 'iters' iteraciones; cada iteracion procesa 'items' elementos.
+struct Case {
+    std::string name;
+    std::size_t items;
+    std::function<void(std::size_t)> run;
+};
+
+struct Result {
+    std::string name;
+    std::size_t iters = 0;
+    std::size_t items = 0;
+    double mean_ns = 0, stddev_ns = 0, min_ns = 0;
+    double items_per_sec = 0;
+};
+
+static std::vector<Case>& Registry()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+static void Add(std::string name, std::size_t items, std::function<void(std::size_t)> run)
+{
+    Registry().push_back({ std::move(name), items, std::move(run) });
+}
+
+struct Options {
+    enum class Format { Console, Json, Csv } format = Format::Console;
+    std::string filter;
+    double min_time_ms = 50.0;
+    int reps = 5;
+    std::size_t threads = 0;   // maximo para el escalado (0: hardware_concurrency)
+};
+
+static double RunOnce(const Case& c, std::size_t iters)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    c.run(iters);
+    ClobberMemory();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static Result Measure(const Case& c, const Options& opt)
+{
+    // Calibracion: duplicar iteraciones hasta que una repeticion dure min_time
+    std::size_t iters = 1;
+    const double target_ns = opt.min_time_ms * 1e6;
+    for (;;) {
+        double ns = RunOnce(c, iters);
+        if (ns >= target_ns || iters >= (std::size_t(1) << 40)) break;
+        double grow = (ns > 0) ? std::min(10.0, std::max(2.0, 1.4 * target_ns / ns)) : 10.0;
+        iters = static_cast<std::size_t>(iters * grow);
+    }
+
+    std::vector<double> per_op;
+    for (int r = 0; r < opt.reps; ++r) {
+        per_op.push_back(RunOnce(c, iters) / static_cast<double>(iters));
+    }
+    double mean = 0;
+    for (double v : per_op) mean += v;
+    mean /= per_op.size();
+    double var = 0;
+    for (double v : per_op) var += (v - mean) * (v - mean);
+    var = per_op.size() > 1 ? var / (per_op.size() - 1) : 0.0;
+
+    Result R;
+    R.name = c.name;
+    R.iters = iters;
+    R.items = c.items;
+    R.mean_ns = mean;
+    R.stddev_ns = std::sqrt(var);
+    R.min_ns = *std::min_element(per_op.begin(), per_op.end());
+    R.items_per_sec = (mean > 0) ? c.items * 1e9 / mean : 0.0;
+    return R;
+}
+
+// -------------------- Datos de entrada -------------------
+// Pool de entradas precalculadas: se recorren ciclicamente para que el
+// compilador no pueda sacar la llamada fuera del bucle.
+static constexpr std::size_t POOL = 256;
+static constexpr std::size_t BATCH = 4096;
+static constexpr double PI = 3.14159265358979323846;
+
+struct Inputs {
+    std::vector<Vec3> v, u, s;
+    std::vector<Quat> q, q2;
+    std::vector<Matrix3x3> R, R2, A;
+    std::vector<Matrix4x4> M, P;
+    std::vector<double> t;
+    std::vector<double> x, y, z;
+    std::vector<double> ox, oy, oz;
+
+    explicit Inputs(std::size_t n)
+    {
+        std::mt19937 g(1234);
+        std::uniform_real_distribution<double> U(-1.0, 1.0);
+        auto rv = [&] { return Vec3{ U(g), U(g), U(g) }; };
+        auto ru = [&] { Vec3 a = rv(); return a.Normalize(); };
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(rv());
+            u.push_back(ru());
+            s.push_back(Vec3{ 2 + u.back().x, 2 + u.back().y, 2 + u.back().z });
+            q.push_back(Quat::FromAxisAngle(ru(), PI * U(g)));
+            q2.push_back(Quat::FromAxisAngle(ru(), PI * U(g)));
+            R.push_back(q.back().ToMatrix3x3());
+            R2.push_back(q2.back().ToMatrix3x3());
+            Matrix3x3 a;
+            for (double& e : a.m) e = U(g);
+            A.push_back(a);
+            M.push_back(Matrix4x4::FromTRS(rv(), q.back(), Vec3{ 1.5 + U(g), 1.5 + U(g), 1.5 + U(g) }));
+            Matrix4x4 p = M.back();
+            p.At(3, 0) = 0.1 * U(g); p.At(3, 2) = -1.0;
+            P.push_back(p);
+            t.push_back(0.5 + 0.5 * U(g));
+            x.push_back(U(g)); y.push_back(U(g)); z.push_back(U(g));
+        }
+        ox.resize(n); oy.resize(n); oz.resize(n);
+    }
+};
+
+// Caso de llamada individual: f(i) con i ciclico sobre el pool
+template <typename F>
+static void Single(const std::string& name, F f)
+{
+    Add(name, 1, [f](std::size_t iters) {
+        for (std::size_t k = 0; k < iters; ++k) {
+            DoNotOptimize(f(k & (POOL - 1)));
+        }
+    });
+}
+
+// Igual para funciones void (ToAxisAngle, setters...)
+template <typename F>
+static void SingleVoid(const std::string& name, F f)
+{
+    Add(name, 1, [f](std::size_t iters) {
+        for (std::size_t k = 0; k < iters; ++k) {
+            f(k & (POOL - 1));
+            ClobberMemory();
+        }
+    });
+}
+
+// Caso en lote: una iteracion = una llamada sobre BATCH elementos
+template <typename F>
+static void Batch(const std::string& name, F f)
+{
+    Add(name, BATCH, [f](std::size_t iters) {
+        for (std::size_t k = 0; k < iters; ++k) {
+            f();
+            ClobberMemory();
+        }
+    });
+}
+
+// -------------------- Casos ------------------------------
+static void RegisterVec3(const Inputs& in)
+{
+    Single("Vec3::Dot", [&](std::size_t i) { return Vec3::Dot(in.v[i], in.u[i]); });
+    Single("Vec3::Cross", [&](std::size_t i) { return Vec3::Cross(in.v[i], in.u[i]); });
+    Single("Vec3::Norm", [&](std::size_t i) { return in.v[i].Norm(); });
+    Single("Vec3::Normalize", [&](std::size_t i) { return in.v[i].Normalize(); });
+}
+
+static void RegisterMatrix3x3(const Inputs& in)
+{
+    Single("Matrix3x3::Identity", [&](std::size_t) { return Matrix3x3::Identity(); });
+    Single("Matrix3x3::Multiply(Vec3)", [&](std::size_t i) { return in.A[i].Multiply(in.v[i]); });
+    Single("Matrix3x3::Multiply(Matrix3x3)", [&](std::size_t i) { return in.A[i].Multiply(in.R[i]); });
+    Single("Matrix3x3::Det", [&](std::size_t i) { return in.A[i].Det(); });
+    Single("Matrix3x3::Transposed", [&](std::size_t i) { return in.A[i].Transposed(); });
+    Single("Matrix3x3::Trace", [&](std::size_t i) { return in.A[i].Trace(); });
+    Single("Matrix3x3::IsRotation", [&](std::size_t i) { return in.R[i].IsRotation(); });
+    Single("Matrix3x3::RotationAxisAngle", [&](std::size_t i) { return Matrix3x3::RotationAxisAngle(in.u[i], in.t[i]); });
+    SingleVoid("Matrix3x3::ToAxisAngle", [&](std::size_t i) {
+        Vec3 a; double phi; in.R[i].ToAxisAngle(a, phi); DoNotOptimize(a); DoNotOptimize(phi);
+    });
+    Single("Matrix3x3::Rotate", [&](std::size_t i) { return in.R[i].Rotate(in.v[i]); });
+    Single("Matrix3x3::FromEulerZYX", [&](std::size_t i) { return Matrix3x3::FromEulerZYX(in.v[i].x, in.v[i].y, in.v[i].z); });
+    SingleVoid("Matrix3x3::ToEulerZYX", [&](std::size_t i) {
+        double a, b, c; in.R[i].ToEulerZYX(a, b, c); DoNotOptimize(a); DoNotOptimize(b); DoNotOptimize(c);
+    });
+    Single("Matrix3x3::RotateFromTo", [&](std::size_t i) { return Matrix3x3::RotateFromTo(in.u[i], in.u[(i + 1) & (POOL - 1)]); });
+    Single("Matrix3x3::RotateToTarget", [&](std::size_t i) { return Matrix3x3::RotateToTarget(in.R[i], in.R2[i]); });
+}
+
+static void RegisterQuat(const Inputs& in, const Inputs& big)
+{
+    Single("Quat::Normalized", [&](std::size_t i) { return in.q[i].Normalized(); });
+    Single("Quat::Multiply", [&](std::size_t i) { return in.q[i].Multiply(in.q2[i]); });
+    Single("Quat::Rotate", [&](std::size_t i) { return in.q[i].Rotate(in.v[i]); });
+    Single("Quat::FromMatrix3x3", [&](std::size_t i) { return Quat::FromMatrix3x3(in.R[i]); });
+    Single("Quat::FromMatrix3x3Unchecked", [&](std::size_t i) { return Quat::FromMatrix3x3Unchecked(in.R[i]); });
+    Single("Quat::ToMatrix3x3", [&](std::size_t i) { return in.q[i].ToMatrix3x3(); });
+    Single("Quat::FromAxisAngle", [&](std::size_t i) { return Quat::FromAxisAngle(in.u[i], in.t[i]); });
+    SingleVoid("Quat::ToAxisAngle", [&](std::size_t i) {
+        Vec3 a; double phi; in.q[i].ToAxisAngle(a, phi); DoNotOptimize(a); DoNotOptimize(phi);
+    });
+    Single("Quat::FromEulerZYX", [&](std::size_t i) { return Quat::FromEulerZYX(in.v[i].x, in.v[i].y, in.v[i].z); });
+    SingleVoid("Quat::ToEulerZYX", [&](std::size_t i) {
+        double a, b, c; in.q[i].ToEulerZYX(a, b, c); DoNotOptimize(a); DoNotOptimize(b); DoNotOptimize(c);
+    });
+    Single("Quat::RotateFromTo", [&](std::size_t i) { return Quat::RotateFromTo(in.u[i], in.u[(i + 1) & (POOL - 1)]); });
+    Single("Quat::RotateToTarget", [&](std::size_t i) { return Quat::RotateToTarget(in.q[i], in.q2[i]); });
+    Single("Quat::Dot", [&](std::size_t i) { return Quat::Dot(in.q[i], in.q2[i]); });
+    Single("Quat::Slerp", [&](std::size_t i) { return Quat::Slerp(in.q[i], in.q2[i], in.t[i]); });
+    Single("Quat::Nlerp", [&](std::size_t i) { return Quat::Nlerp(in.q[i], in.q2[i], in.t[i]); });
+    Single("Quat::SlerpFast", [&](std::size_t i) { return Quat::SlerpFast(in.q[i], in.q2[i], in.t[i]); });
+
+    static std::vector<Quat> out(BATCH);
+    static std::vector<Vec3> vout(BATCH);
+    static std::vector<double> ox(BATCH), oy(BATCH), oz(BATCH);
+    const Quat& q0 = in.q[0];
+    Batch("Quat::Rotate/loop", [&] { for (std::size_t i = 0; i < BATCH; ++i) vout[i] = q0.Rotate(big.v[i]); });
+    Batch("Quat::RotateMany/AoS", [&] { q0.RotateMany(big.v, vout); });
+    Batch("Quat::RotateMany/SoA", [&] { q0.RotateMany(big.x, big.y, big.z, ox, oy, oz); });
+    Batch("Quat::RotateMany/per-quat/AoS", [&] { Quat::RotateMany(big.q, big.v, vout); });
+    Batch("Quat::RotateMany/per-quat/SoA", [&] { Quat::RotateMany(big.q, big.x, big.y, big.z, ox, oy, oz); });
+    static std::vector<Quat> qtrack(BATCH);
+    Batch("Quat::FromMatrix3x3/loop", [&] { for (std::size_t i = 0; i < BATCH; ++i) qtrack[i] = Quat::FromMatrix3x3(big.R[i]); });
+    Batch("Quat::FromMatrix3x3ManyUnchecked", [&] { Quat::FromMatrix3x3ManyUnchecked(big.R, qtrack); });
+    Batch("Quat::SlerpMany", [&] { Quat::SlerpMany(big.q, big.q2, big.t, out); });
+    Batch("Quat::NlerpMany", [&] { Quat::NlerpMany(big.q, big.q2, big.t, out); });
+    Batch("Quat::SlerpFastMany", [&] { Quat::SlerpFastMany(big.q, big.q2, big.t, out); });
+}
+
+static void RegisterMatrix4x4(const Inputs& in, const Inputs& big)
+{
+    Single("Matrix4x4::Identity", [&](std::size_t) { return Matrix4x4::Identity(); });
+    Single("Matrix4x4::Multiply(Matrix4x4)", [&](std::size_t i) { return in.M[i].Multiply(in.M[(i + 1) & (POOL - 1)]); });
+    Single("Matrix4x4::Multiply(Vec4)", [&](std::size_t i) { return in.M[i].Multiply(Vec4(in.v[i], 1.0)); });
+    // Cadena de cuatro matrices por un vector: temporales 4x4 frente a expresion perezosa
+    Single("Matrix4x4 cadena*Vec4/eager", [&](std::size_t i) {
+        const std::size_t j = (i + 1) & (POOL - 1), k = (i + 2) & (POOL - 1), l = (i + 3) & (POOL - 1);
+        return in.M[i].Multiply(in.M[j]).Multiply(in.M[k]).Multiply(in.M[l]).Multiply(Vec4(in.v[i], 1.0));
+    });
+    Single("Matrix4x4 cadena*Vec4/expr", [&](std::size_t i) {
+        const std::size_t j = (i + 1) & (POOL - 1), k = (i + 2) & (POOL - 1), l = (i + 3) & (POOL - 1);
+        return in.M[i] * in.M[j] * in.M[k] * in.M[l] * Vec4(in.v[i], 1.0);
+    });
+    Single("Matrix4x4::MultiplyAffine", [&](std::size_t i) { return in.M[i].MultiplyAffine(in.M[(i + 1) & (POOL - 1)]); });
+    Single("Matrix4x4::IsAffine", [&](std::size_t i) { return in.M[i].IsAffine(); });
+    Single("Matrix4x4::TransformPoint", [&](std::size_t i) { return in.M[i].TransformPoint(in.v[i]); });
+    Single("Matrix4x4::TransformPoint/proj", [&](std::size_t i) { return in.P[i].TransformPoint(in.v[i]); });
+    Single("Matrix4x4::ProjectToNDC", [&](std::size_t i) { return in.P[i].ProjectToNDC(in.v[i]); });
+    Single("Matrix4x4::Perspective", [&](std::size_t i) { return Matrix4x4::Perspective(1.0 + 0.1 * in.t[i], 1.5, 0.1, 100.0); });
+    Single("Matrix4x4::Orthographic", [&](std::size_t i) { return Matrix4x4::Orthographic(-1, 1 + in.t[i], -1, 1, 0.1, 100.0); });
+    Single("Matrix4x4::LookAt", [&](std::size_t i) { return Matrix4x4::LookAt(in.v[i], in.u[i], Vec3{ 0, 1, 0 }); });
+    Single("Matrix4x4::TransformVector", [&](std::size_t i) { return in.M[i].TransformVector(in.v[i]); });
+    Single("Matrix4x4::Translate", [&](std::size_t i) { return Matrix4x4::Translate(in.v[i]); });
+    Single("Matrix4x4::Scale", [&](std::size_t i) { return Matrix4x4::Scale(in.v[i]); });
+    Single("Matrix4x4::Rotate(Matrix3x3)", [&](std::size_t i) { return Matrix4x4::Rotate(in.R[i]); });
+    Single("Matrix4x4::Rotate(Quat)", [&](std::size_t i) { return Matrix4x4::Rotate(in.q[i]); });
+    Single("Matrix4x4::FromTRS(Matrix3x3)", [&](std::size_t i) { return Matrix4x4::FromTRS(in.v[i], in.R[i], in.u[i]); });
+    Single("Matrix4x4::FromTRS(Quat)", [&](std::size_t i) { return Matrix4x4::FromTRS(in.v[i], in.q[i], in.u[i]); });
+    Single("Matrix4x4::InverseTR", [&](std::size_t i) { return Matrix4x4::FromTRS(in.v[i], in.q[i], Vec3{ 1, 1, 1 }).InverseTR(); });
+    Single("Matrix4x4::InverseTRS", [&](std::size_t i) { return in.M[i].InverseTRS(); });
+    Single("Matrix4x4::Det", [&](std::size_t i) { return in.P[i].Det(); });
+    Single("Matrix4x4::Inverse", [&](std::size_t i) { return in.P[i].Inverse(); });
+    Single("Matrix4x4::TryInverse", [&](std::size_t i) { return in.P[i].TryInverse(); });
+    Single("Matrix4x4::GetTranslation", [&](std::size_t i) { return in.M[i].GetTranslation(); });
+    Single("Matrix4x4::GetRotation", [&](std::size_t i) { return in.M[i].GetRotation(); });
+    Single("Matrix4x4::GetRotationQuat", [&](std::size_t i) { return in.M[i].GetRotationQuat(); });
+    Single("Matrix4x4::GetScale", [&](std::size_t i) { return in.M[i].GetScale(); });
+    Single("Matrix4x4::GetRotationScale", [&](std::size_t i) { return in.M[i].GetRotationScale(); });
+    Single("Matrix4x4::GetTranslationUnchecked", [&](std::size_t i) { return in.M[i].GetTranslationUnchecked(); });
+    Single("Matrix4x4::GetRotationUnchecked", [&](std::size_t i) { return in.M[i].GetRotationUnchecked(); });
+    Single("Matrix4x4::GetRotationQuatUnchecked", [&](std::size_t i) { return in.M[i].GetRotationQuatUnchecked(); });
+    Single("Matrix4x4::GetScaleUnchecked", [&](std::size_t i) { return in.M[i].GetScaleUnchecked(); });
+    Single("Matrix4x4::TryGetRotationQuat", [&](std::size_t i) { return in.M[i].TryGetRotationQuat(); });
+
+    static Matrix4x4 W;
+    SingleVoid("Matrix4x4::SetTranslation", [&](std::size_t i) { W = in.M[i]; W.SetTranslation(in.v[i]); });
+    SingleVoid("Matrix4x4::SetRotation(Matrix3x3)", [&](std::size_t i) { W = in.M[i]; W.SetRotation(in.R[i]); });
+    SingleVoid("Matrix4x4::SetRotation(Quat)", [&](std::size_t i) { W = in.M[i]; W.SetRotation(in.q[i]); });
+    SingleVoid("Matrix4x4::SetScale", [&](std::size_t i) { W = in.M[i]; W.SetScale(in.u[i]); });
+    SingleVoid("Matrix4x4::SetRotationScale", [&](std::size_t i) { W = in.M[i]; W.SetRotationScale(in.A[i]); });
+    SingleVoid("Matrix4x4::SetRotationUnchecked(Quat)", [&](std::size_t i) { W = in.M[i]; W.SetRotationUnchecked(in.q[i]); });
+    SingleVoid("Matrix4x4::SetScaleUnchecked", [&](std::size_t i) { W = in.M[i]; W.SetScaleUnchecked(in.u[i]); });
+    Single("Matrix4x4::NormalMatrix", [&](std::size_t i) { return in.M[i].NormalMatrix(); });
+    Single("Matrix4x4::NormalMatrixExact", [&](std::size_t i) { return in.M[i].NormalMatrixExact(); });
+    Single("InverseTRS().Transposed()", [&](std::size_t i) { return in.M[i].InverseTRS().GetRotationScaleUnchecked().Transposed(); });
+    SingleVoid("Matrix4x4::Decompose", [&](std::size_t i) {
+        Vec3 t, s; Quat q; in.M[i].Decompose(t, q, s); DoNotOptimize(t); DoNotOptimize(q); DoNotOptimize(s);
+    });
+    SingleVoid("Matrix4x4::DecomposeUnchecked", [&](std::size_t i) {
+        Vec3 t, s; Quat q; in.M[i].DecomposeUnchecked(t, q, s); DoNotOptimize(t); DoNotOptimize(q); DoNotOptimize(s);
+    });
+
+    static std::vector<Vec3> pout(BATCH), sout(BATCH);
+    static std::vector<Quat> qout(BATCH);
+    static std::vector<Matrix4x4> mout(BATCH);
+    static std::vector<double> ox(BATCH), oy(BATCH), oz(BATCH);
+    const Matrix4x4& M = in.M[0];
+    const Matrix4x4& P = in.P[0];
+    Batch("Matrix4x4::TransformPoints/AoS", [&] { M.TransformPoints(big.v, pout); });
+    Batch("Matrix4x4::TransformPoints/AoS/proj", [&] { P.TransformPoints(big.v, pout); });
+    Batch("Matrix4x4::ProjectToNDC/AoS", [&] { P.ProjectToNDC(big.v, pout); });
+    Batch("Matrix4x4::ProjectToNDC/SoA", [&] { P.ProjectToNDC(big.x, big.y, big.z, ox, oy, oz); });
+    Batch("Matrix4x4::TransformVectors/AoS", [&] { M.TransformVectors(big.v, pout); });
+    Batch("Matrix4x4::TransformPoints/SoA", [&] { M.TransformPoints(big.x, big.y, big.z, ox, oy, oz); });
+    Batch("Matrix4x4::TransformVectors/SoA", [&] { M.TransformVectors(big.x, big.y, big.z, ox, oy, oz); });
+    Batch("Matrix4x4::TransformNormals/AoS", [&] { M.TransformNormals(big.v, pout); });
+    Batch("Matrix4x4::TransformNormals/SoA", [&] { M.TransformNormals(big.x, big.y, big.z, ox, oy, oz); });
+    // Referencia: (M^-1)^T con InverseTRS y normalizacion escalar
+    Batch("InverseTRS^T + Normalize/AoS", [&] {
+        const Matrix3x3 N = M.InverseTRS().GetRotationScaleUnchecked().Transposed();
+        for (std::size_t i = 0; i < BATCH; ++i) pout[i] = N.Multiply(big.v[i]).Normalize();
+    });
+    Batch("Matrix4x4::InverseMany", [&] { DoNotOptimize(Matrix4x4::InverseMany(big.P, mout)); });
+    Batch("Matrix4x4::InverseTRSMany", [&] { Matrix4x4::InverseTRSMany(big.M, mout); });
+    Batch("Matrix4x4::DecomposeMany", [&] { Matrix4x4::DecomposeMany(big.M, pout, qout, sout); });
+}
+
+static void RegisterTransform(const Inputs& in)
+{
+    // Tres setters seguidos (escala en [1, 3]) y una lectura de la matriz
+    static Matrix4x4 W = Matrix4x4::Identity();
+    SingleVoid("Matrix4x4 SetT+SetR+SetS", [&](std::size_t i) {
+        W.SetTranslation(in.v[i]); W.SetRotation(in.q[i]); W.SetScale(in.s[i]);
+    });
+    static Transform X;
+    SingleVoid("Transform SetT+SetR+SetS", [&](std::size_t i) {
+        X.SetTranslation(in.v[i]); X.SetRotation(in.q[i]); X.SetScale(in.s[i]);
+    });
+    Single("Transform SetT+SetR+SetS+Matrix", [&](std::size_t i) {
+        X.SetTranslation(in.v[i]); X.SetRotation(in.q[i]); X.SetScale(in.s[i]);
+        return X.Matrix();
+    });
+    Single("Transform::Matrix/cache", [&](std::size_t) { return X.Matrix(); });
+    Single("Transform::Inverse", [&](std::size_t i) { X.SetTranslation(in.v[i]); return X.Inverse(); });
+    Single("Matrix4x4::InverseTRS", [&](std::size_t i) { return in.M[i].InverseTRS(); });
+}
+
+static void RegisterDualQuat(const Inputs& in, const Inputs& big)
+{
+    static std::vector<DualQuat> dq, pal;
+    static std::vector<std::uint16_t> idx;
+    static std::vector<double> w;
+    static std::vector<Vec3> pout(BATCH), nout(BATCH);
+    for (std::size_t i = 0; i < POOL; ++i) dq.push_back(DualQuat::FromRotationTranslation(in.q[i], in.v[i]));
+    for (std::size_t b = 0; b < 64; ++b) pal.push_back(dq[b]);
+    for (std::size_t i = 0; i < BATCH; ++i) {
+        for (std::size_t k = 0; k < 4; ++k) {
+            idx.push_back(static_cast<std::uint16_t>((i * 7 + k * 13) % pal.size()));
+            w.push_back(k == 0 ? 0.4 : 0.2);
+        }
+    }
+    Single("DualQuat::FromRotationTranslation", [&](std::size_t i) { return DualQuat::FromRotationTranslation(in.q[i], in.v[i]); });
+    Single("DualQuat::Multiply", [&](std::size_t i) { return dq[i].Multiply(dq[(i + 1) & (POOL - 1)]); });
+    Single("DualQuat::Inverse", [&](std::size_t i) { return dq[i].Inverse(); });
+    Single("DualQuat::TransformPoint", [&](std::size_t i) { return dq[i].TransformPoint(in.v[i]); });
+    Single("DualQuat::ToMatrix4x4", [&](std::size_t i) { return dq[i].ToMatrix4x4(); });
+    Batch("DualQuat::SkinMany", [&] { DualQuat::SkinMany(pal, big.v, idx, w, pout, big.u, nout); });
+}
+
+static void RegisterSkinning(const Inputs& in, const Inputs& big)
+{
+    static std::vector<Affine3x4> pal;
+    static std::vector<Matrix4x4> bones;
+    static std::vector<std::uint16_t> idx;
+    static std::vector<double> w;
+    static std::vector<double> ox(BATCH), oy(BATCH), oz(BATCH), onx(BATCH), ony(BATCH), onz(BATCH);
+    static std::vector<Vec3> pout(BATCH), nout(BATCH);
+    for (std::size_t b = 0; b < 64; ++b) {
+        bones.push_back(in.M[b]);
+        pal.push_back(Affine3x4::FromMatrix4x4(in.M[b]));
+    }
+    for (std::size_t i = 0; i < BATCH; ++i) {
+        for (std::size_t k = 0; k < 4; ++k) {
+            idx.push_back(static_cast<std::uint16_t>((i * 7 + k * 13) % pal.size()));
+            w.push_back(k == 0 ? 0.4 : 0.2);
+        }
+    }
+    static const SkinStreams streams{ big.x, big.y, big.z, big.x, big.y, big.z, idx, w };
+    static const SkinTargets targets{ ox, oy, oz, onx, ony, onz };
+    Batch("Skinning::SkinLinear", [&] { Skinning::SkinLinear(pal, streams, targets); });
+    // Referencia: el camino anterior, 4 TransformPoint/TransformVector ponderados por vertice
+    Batch("Skinning::Matrix4x4Reference", [&] {
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            Vec3 p{ 0, 0, 0 }, n{ 0, 0, 0 };
+            for (std::size_t k = 0; k < 4; ++k) {
+                const Matrix4x4& M = bones[idx[4 * i + k]];
+                const double wk = w[4 * i + k];
+                Vec3 a = M.TransformPoint(big.v[i]), b = M.TransformVector(big.u[i]);
+                p = { p.x + wk * a.x, p.y + wk * a.y, p.z + wk * a.z };
+                n = { n.x + wk * b.x, n.y + wk * b.y, n.z + wk * b.z };
+            }
+            pout[i] = p; nout[i] = n;
+        }
+    });
+}
+
+// Culling de un lote de cajas y esferas contra una camara que ve ~1/4 de la escena
+static void RegisterBounds(const Inputs& big)
+{
+    static const Matrix4x4 VP = Matrix4x4::Perspective(PI / 3, 1.5, 0.1, 10.0)
+        .Multiply(Matrix4x4::LookAt(Vec3{ 0, 0, 2 }, Vec3{ 0, 0, 0 }, Vec3{ 0, 1, 0 }));
+    static const Frustum F = Frustum::FromViewProjection(VP);
+    static std::vector<AABB> boxes;
+    static std::vector<Sphere> spheres;
+    static std::vector<std::uint64_t> mask((BATCH + 63) / 64);
+    static std::vector<char> ref(BATCH);
+    for (std::size_t i = 0; i < BATCH; ++i) {
+        const Vec3 c{ 4 * big.x[i], 4 * big.y[i], 4 * big.z[i] };
+        boxes.push_back({ { c.x - 0.1, c.y - 0.1, c.z - 0.1 }, { c.x + 0.1, c.y + 0.1, c.z + 0.1 } });
+        spheres.push_back({ c, 0.17 });
+    }
+    static std::vector<AABB> tboxes(BATCH);
+    static std::vector<Matrix4x4> world;
+    for (std::size_t i = 0; i < BATCH; ++i) world.push_back(big.M[i % POOL]);
+    Single("AABB::Transformed", [&](std::size_t i) { return boxes[i].Transformed(big.M[i]); });
+    Single("AABB::TransformCorners", [&](std::size_t i) {
+        const AABB& b = boxes[i];
+        Vec3 c[8];
+        for (int k = 0; k < 8; ++k) {
+            c[k] = big.M[i].TransformPoint(Vec3{ (k & 1) ? b.max.x : b.min.x, (k & 2) ? b.max.y : b.min.y,
+                                                 (k & 4) ? b.max.z : b.min.z });
+        }
+        return AABB::FromPoints(c);
+    });
+    Batch("AABB::TransformMany/OneMatrix", [&] { AABB::TransformMany(big.M[0], boxes, tboxes); });
+    Batch("AABB::TransformMany/PerBox", [&] { AABB::TransformMany(world, boxes, tboxes); });
+    Batch("Frustum::Cull/AABB", [&] { DoNotOptimize(F.Cull(boxes, mask)); });
+    Batch("Frustum::Cull/Sphere", [&] { DoNotOptimize(F.Cull(spheres, mask)); });
+    // Referencia: las ocho esquinas con TransformPoint y test en NDC
+    Batch("Frustum::CornersReference", [&] {
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            const AABB& b = boxes[i];
+            int out[6] = { 0 };
+            for (int k = 0; k < 8; ++k) {
+                const Vec3 p = VP.TransformPoint(Vec3{ (k & 1) ? b.max.x : b.min.x, (k & 2) ? b.max.y : b.min.y,
+                                                       (k & 4) ? b.max.z : b.min.z });
+                out[0] += p.x < -1; out[1] += p.x > 1; out[2] += p.y < -1;
+                out[3] += p.y > 1; out[4] += p.z < -1; out[5] += p.z > 1;
+            }
+            ref[i] = out[0] < 8 && out[1] < 8 && out[2] < 8 && out[3] < 8 && out[4] < 8 && out[5] < 8;
+        }
+    });
+}
+
+// Codificacion compacta de transformaciones
+static void RegisterQuantize(const Inputs& in, const Inputs& big)
+{
+    static const AABB range{ { -4, -4, -4 }, { 4, 4, 4 } };
+    static std::vector<PackedTransform32> p32(BATCH);
+    static std::vector<PackedTransform48> p48(BATCH);
+    static std::vector<Matrix4x4> world, out(BATCH);
+    for (std::size_t i = 0; i < BATCH; ++i) world.push_back(big.M[i]);
+    Quantize::EncodeMany(world, range, p32);
+    Quantize::EncodeMany(world, range, p48);
+    Single("Quantize::EncodeQuat32", [&](std::size_t i) { return Quantize::EncodeQuat32(in.q[i]); });
+    Single("Quantize::DecodeQuat32", [&](std::size_t i) { return Quantize::DecodeQuat32(static_cast<std::uint32_t>(i * 2654435761u)); });
+    Single("Quantize::EncodeHalf", [&](std::size_t i) { return Quantize::EncodeHalf(in.t[i]); });
+    Batch("Quantize::EncodeMany/32", [&] { Quantize::EncodeMany(world, range, p32); });
+    Batch("Quantize::EncodeMany/48", [&] { Quantize::EncodeMany(world, range, p48); });
+    Batch("Quantize::DecodeMany/32", [&] { Quantize::DecodeMany(p32, range, out); });
+    Batch("Quantize::DecodeMany/48", [&] { Quantize::DecodeMany(p48, range, out); });
+}
+
+// Pistas binarias: escritura, apertura mmap + checksum, y la lectura de texto anterior
+static void RegisterStream(const Inputs& big)
+{
+    static const std::string path = (std::filesystem::temp_directory_path() / "lab3_perf.l3ts").string();
+    static std::vector<Matrix4x4> out(BATCH);
+    static std::string text;
+    {
+        TransformStreamWriter<Matrix4x4> w(path);
+        w.Write(big.M);
+        std::ostringstream os;
+        os.precision(17);
+        for (const Matrix4x4& M : big.M) {
+            for (double e : M.m) os << e << ' ';
+        }
+        text = os.str();
+    }
+    Batch("TransformStream::Write", [&] { TransformStreamWriter<Matrix4x4> w(path); w.Write(big.M); });
+    Batch("TransformStream::OpenVerify", [&] {
+        TransformStreamReader<Matrix4x4> r(path);
+        DoNotOptimize(r.Records().data());
+    });
+    Batch("TransformStream::TextParse", [&] {
+        std::istringstream is(text);
+        for (Matrix4x4& M : out) {
+            for (double& e : M.m) is >> e;
+        }
+    });
+}
+
+// Escalado con hilos: el mismo lote grande con pools de 1, 2, 4, ... N hilos
+static void RegisterArena(const Inputs& big)
+{
+    // Un "frame": buffers temporales para las inversas y los puntos transformados
+    const Matrix4x4& M = big.M[0];
+    Batch("Frame buffers/std::vector", [&] {
+        std::vector<Matrix4x4> inv(BATCH);
+        std::vector<double> ox(BATCH), oy(BATCH), oz(BATCH);
+        Matrix4x4::InverseTRSMany(big.M, inv);
+        M.TransformPoints(big.x, big.y, big.z, ox, oy, oz);
+        DoNotOptimize(inv.data()); DoNotOptimize(ox.data());
+    });
+    static FrameArena arena(std::size_t(1) << 20);
+    Batch("Frame buffers/FrameArena", [&] {
+        arena.Reset();
+        std::span<Matrix4x4> inv = arena.AllocateUninitialized<Matrix4x4>(BATCH);
+        Vec3SoA out = Vec3SoA::Allocate(arena, BATCH);
+        Matrix4x4::InverseTRSMany(big.M, inv);
+        M.TransformPoints(big.x, big.y, big.z, out.x, out.y, out.z);
+        DoNotOptimize(inv.data()); DoNotOptimize(out.x.data());
+    });
+    // Solo la reserva y liberacion
+    Batch("Alloc/std::vector", [&] {
+        std::vector<Matrix4x4> a(BATCH);
+        std::vector<double> b(BATCH), c(BATCH), d(BATCH);
+        DoNotOptimize(a.data()); DoNotOptimize(b.data()); DoNotOptimize(c.data()); DoNotOptimize(d.data());
+    });
+    Batch("Alloc/FrameArena", [&] {
+        arena.Reset();
+        std::span<Matrix4x4> a = arena.AllocateArray<Matrix4x4>(BATCH);
+        Vec3SoA b = Vec3SoA::Allocate(arena, BATCH);
+        DoNotOptimize(a.data()); DoNotOptimize(b.x.data());
+    });
+    Batch("Alloc/FrameArena/uninit", [&] {
+        arena.Reset();
+        std::span<Matrix4x4> a = arena.AllocateUninitialized<Matrix4x4>(BATCH);
+        Vec3SoA b = Vec3SoA::Allocate(arena, BATCH);
+        DoNotOptimize(a.data()); DoNotOptimize(b.x.data());
+    });
+}
+
+static void RegisterParallel(std::size_t max_threads)
+{
+    static constexpr std::size_t BIG = std::size_t(1) << 21;
+    static std::vector<std::unique_ptr<ThreadPool>> pools;
+    static std::vector<Vec3> in(BIG), out(BIG);
+    static std::vector<double> x(BIG), y(BIG), z(BIG), ox(BIG), oy(BIG), oz(BIG);
+    std::mt19937 g(77);
+    std::uniform_real_distribution<double> U(-1.0, 1.0);
+    for (std::size_t i = 0; i < BIG; ++i) {
+        in[i] = Vec3{ U(g), U(g), U(g) };
+        x[i] = in[i].x; y[i] = in[i].y; z[i] = in[i].z;
+    }
+    static const Matrix4x4 M = Matrix4x4::FromTRS(Vec3{ 1, 2, 3 }, Quat::FromAxisAngle(Vec3{ 0, 0, 1 }, 0.5), Vec3{ 2, 2, 2 });
+
+    if (max_threads == 0) max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> counts;
+    for (std::size_t k = 1; k < max_threads; k *= 2) counts.push_back(k);
+    counts.push_back(max_threads);
+
+    for (std::size_t k : counts) {
+        pools.push_back(std::make_unique<ThreadPool>(k));
+        ThreadPool& pool = *pools.back();
+        const std::string suffix = "/threads:" + std::to_string(k);
+        Add("Parallel::TransformPoints/AoS" + suffix, BIG, [&pool](std::size_t iters) {
+            for (std::size_t it = 0; it < iters; ++it) { TransformPointsParallel(M, in, out, pool); ClobberMemory(); }
+        });
+        Add("Parallel::TransformPoints/SoA" + suffix, BIG, [&pool](std::size_t iters) {
+            for (std::size_t it = 0; it < iters; ++it) { TransformPointsParallel(M, x, y, z, ox, oy, oz, pool); ClobberMemory(); }
+        });
+    }
+}
+
+// -------------------- Salida -----------------------------
+static void PrintConsole(const std::vector<Result>& results)
+{
+    std::printf("%-44s %14s %12s %12s %14s %12s\n", "Benchmark", "ns/op", "stddev", "min", "items/s", "iters");
+    std::printf("%s\n", std::string(112, '-').c_str());
+    for (const Result& r : results) {
+        std::printf("%-44s %14.2f %12.2f %12.2f %14.4g %12zu\n",
+            r.name.c_str(), r.mean_ns, r.stddev_ns, r.min_ns, r.items_per_sec, r.iters);
+    }
+}
+
+static void PrintCsv(const std::vector<Result>& results)
+{
+    std::printf("name,iterations,items_per_iteration,ns_per_op,stddev_ns,min_ns,items_per_second\n");
+    for (const Result& r : results) {
+        std::printf("\"%s\",%zu,%zu,%.4f,%.4f,%.4f,%.6g\n",
+            r.name.c_str(), r.iters, r.items, r.mean_ns, r.stddev_ns, r.min_ns, r.items_per_sec);
+    }
+}
+
+static void PrintJson(const std::vector<Result>& results, const Options& opt)
+{
+    std::printf("{\n  \"context\": {\n");
+    std::printf("    \"simd_detected\": \"%s\",\n", ToString(DetectSimdLevel()));
+    std::printf("    \"simd_active\": \"%s\",\n", ToString(GetSimdLevel()));
+    std::printf("    \"repetitions\": %d,\n", opt.reps);
+    std::printf("    \"min_time_ms\": %.1f,\n", opt.min_time_ms);
+    std::printf("    \"batch_size\": %zu\n  },\n", BATCH);
+    std::printf("  \"benchmarks\": [\n");
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        const Result& r = results[k];
+        std::printf("    {\"name\": \"%s\", \"iterations\": %zu, \"items_per_iteration\": %zu, "
+            "\"ns_per_op\": %.4f, \"stddev_ns\": %.4f, \"min_ns\": %.4f, \"items_per_second\": %.6g}%s\n",
+            r.name.c_str(), r.iters, r.items, r.mean_ns, r.stddev_ns, r.min_ns, r.items_per_sec,
+            (k + 1 < results.size()) ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+// -------------------- Main -------------------------------
+static bool ParseArgs(int argc, char** argv, Options& opt)
+{
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        auto value = [&](const char* key) -> const char* {
+            std::size_t n = std::strlen(key);
+            return (arg.compare(0, n, key) == 0) ? arg.c_str() + n : nullptr;
+        };
+        if (arg == "--json") opt.format = Options::Format::Json;
+        else if (arg == "--csv") opt.format = Options::Format::Csv;
+        else if (const char* f = value("--filter=")) opt.filter = f;
+        else if (const char* t = value("--min-time=")) opt.min_time_ms = std::atof(t);
+        else if (const char* r = value("--reps=")) opt.reps = std::max(1, std::atoi(r));
+        else if (const char* n = value("--threads=")) opt.threads = static_cast<std::size_t>(std::max(1, std::atoi(n)));
+        else if (const char* s = value("--simd=")) {
+            std::string l = s;
+            if (l == "scalar") SetSimdLevel(SimdLevel::Scalar);
+            else if (l == "sse2") SetSimdLevel(SimdLevel::SSE2);
+            else if (l == "avx2") SetSimdLevel(SimdLevel::AVX2);
+            else if (l == "fma") SetSimdLevel(SimdLevel::FMA);
+            else { std::cerr << "Nivel SIMD desconocido: " << l << "\n"; return false; }
+        }
+        else {
+            std::cerr << "Uso: perf [--json | --csv] [--filter=texto] [--min-time=ms] [--reps=N]"
+                " [--simd=scalar|sse2|avx2|fma] [--threads=N]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt)) return 1;
+
+    static const Inputs small(POOL);
+    static const Inputs big(BATCH);
+    RegisterVec3(small);
+    RegisterMatrix3x3(small);
+    RegisterQuat(small, big);
+    RegisterMatrix4x4(small, big);
+    RegisterTransform(small);
+    RegisterDualQuat(small, big);
+    RegisterSkinning(small, big);
+    RegisterBounds(big);
+    RegisterQuantize(small, big);
+    RegisterStream(big);
+    RegisterArena(big);
+    RegisterParallel(opt.threads);
+
+    std::vector<Result> results;
+    for (const Case& c : Registry()) {
+        if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+        if (opt.format == Options::Format::Console) {
+            std::fprintf(stderr, "\r%-60s", c.name.c_str());
+        }
+        results.push_back(Measure(c, opt));
+    }
+    if (opt.format == Options::Format::Console) {
+        std::fprintf(stderr, "\r%-60s\r", "");
+        std::printf("SIMD: %s (detectado %s)\n", ToString(GetSimdLevel()), ToString(DetectSimdLevel()));
+    }
+
+    switch (opt.format) {
+    case Options::Format::Json: PrintJson(results, opt); break;
+    case Options::Format::Csv: PrintCsv(results); break;
+    default: PrintConsole(results); break;
+    }
+    return 0;
+}
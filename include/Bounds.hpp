@@ -0,0 +1,95 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include <cstdint>
+#include <span>
+
+// Volums envolupants i frustum culling. Els plans del frustum s'extreuen
+// directament de les files de la matriu vista-projeccio (Gribb/Hartmann),
+// sense transformar les cantonades de cada caixa.
+
+template <typename T>
+struct AABBT
+{
+    Vec3T<T> min, max;
+
+    // Llanca std::invalid_argument si no hi ha cap punt
+    static AABBT FromPoints(std::span<const Vec3T<T>> points);
+
+    Vec3T<T> Center() const { return { (min.x + max.x) * T(0.5), (min.y + max.y) * T(0.5), (min.z + max.z) * T(0.5) }; }
+    Vec3T<T> Extent() const { return { (max.x - min.x) * T(0.5), (max.y - min.y) * T(0.5), (max.z - min.z) * T(0.5) }; }
+    bool Contains(const Vec3T<T>& p) const;
+
+    // Caixa envolupant de la caixa transformada per M (afi), pel metode
+    // centre-extensio d'Arvo: c' = M c, e' = |M3x3| e. Una sola transformacio
+    // en lloc de les 8 cantonades. Transformed llanca std::runtime_error si M
+    // no es afi; la versio Unchecked no ho comprova.
+    AABBT Transformed(const Matrix4x4T<T>& M) const;
+    AABBT TransformedUnchecked(const Matrix4x4T<T>& M) const;
+
+    // En lot, per a estructures de broad-phase que es reconstrueixen cada frame:
+    // una matriu per a totes les caixes o una per caixa (M[i] * in[i]). Validen
+    // mides i afinitat un sol cop abans de comencar; in i out poden coincidir.
+    // Amb AVX2 en double cada carril es una fila de M.
+    static void TransformMany(const Matrix4x4T<T>& M, std::span<const AABBT> in, std::span<AABBT> out);
+    static void TransformMany(std::span<const Matrix4x4T<T>> M, std::span<const AABBT> in, std::span<AABBT> out);
+};
+
+template <typename T>
+AABBT<T> TransformAABB(const Matrix4x4T<T>& M, const AABBT<T>& box)
+{
+    return box.Transformed(M);
+}
+
+template <typename T>
+struct SphereT
+{
+    Vec3T<T> center;
+    T radius = 0;
+};
+
+// Pla n . p + d = 0; la part positiva es l'interior del frustum
+template <typename T>
+struct PlaneT
+{
+    Vec3T<T> n;
+    T d = 0;
+
+    T Distance(const Vec3T<T>& p) const { return n.x * p.x + n.y * p.y + n.z * p.z + d; }
+};
+
+template <typename T>
+struct FrustumT
+{
+    enum Side { Left = 0, Right, Bottom, Top, Near, Far };
+    PlaneT<T> planes[6];
+
+    // Plans de VP = Projection * View (convencio OpenGL, z de clip en [-w, w]).
+    // Es normalitzen perque la distancia sigui euclidiana; un pla amb normal
+    // nul.la (p. ex. far infinit) es deixa tal qual.
+    static FrustumT FromViewProjection(const Matrix4x4T<T>& VP);
+
+    // Conservadors: poden donar visible per objectes prop de les arestes
+    bool Intersects(const AABBT<T>& box) const;
+    bool Intersects(const SphereT<T>& sphere) const;
+
+    // En lot: el bit i de visible (visible[i / 64] >> (i % 64)) indica si el
+    // volum i es visible. visible ha de tenir com a minim (n + 63) / 64 paraules
+    // (si no, std::invalid_argument); els bits sobrants queden a zero.
+    // Retornen el nombre de visibles. Amb AVX2 en double fan quatre per iteracio.
+    std::size_t Cull(std::span<const AABBT<T>> boxes, std::span<std::uint64_t> visible) const;
+    std::size_t Cull(std::span<const SphereT<T>> spheres, std::span<std::uint64_t> visible) const;
+};
+
+extern template struct AABBT<float>;
+extern template struct AABBT<double>;
+extern template struct FrustumT<float>;
+extern template struct FrustumT<double>;
+
+using AABB = AABBT<double>;
+using AABBf = AABBT<float>;
+using Sphere = SphereT<double>;
+using Spheref = SphereT<float>;
+using Plane = PlaneT<double>;
+using Planef = PlaneT<float>;
+using Frustum = FrustumT<double>;
+using Frustumf = FrustumT<float>;
@@ -0,0 +1,57 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include "Quat.hpp"
+#include <cstdint>
+#include <span>
+
+// Quaternio dual unitari per a transformacions rigides (rotacio + translacio):
+// real = rotacio q, dual = 0.5 * t * q. 8 escalars en lloc de 16, i la
+// composicio costa 3 productes de quaternions (48 mul) en lloc de 64.
+template <typename T>
+struct DualQuatT
+{
+    QuatT<T> real;
+    QuatT<T> dual{ 0, 0, 0, 0 };
+
+    static DualQuatT Identity() { return {}; }
+    static DualQuatT FromRotationTranslation(const QuatT<T>& q, const Vec3T<T>& t);
+    // Llanca si la matriu no es afi; l'escala s'ignora (nomes R i t)
+    static DualQuatT FromMatrix4x4(const Matrix4x4T<T>& M);
+    Matrix4x4T<T> ToMatrix4x4() const;
+
+    QuatT<T> GetRotation() const { return real; }
+    Vec3T<T> GetTranslation() const;
+
+    // (A * B) aplica primer B i despres A, com Matrix4x4::Multiply
+    DualQuatT Multiply(const DualQuatT& b) const;
+    DualQuatT operator*(const DualQuatT& b) const
+    {
+        return Multiply(b);
+    }
+    // Per a quaternions duals unitaris la inversa es el conjugat de cada part
+    DualQuatT Inverse() const;
+    DualQuatT Normalized() const;
+
+    Vec3T<T> TransformPoint(const Vec3T<T>& p) const;
+    Vec3T<T> TransformVector(const Vec3T<T>& v) const;
+
+    // Skinning per barreja lineal de quaternions duals (DLB). Per al vertex i,
+    // indices[4*i+k] i weights[4*i+k] (k = 0..3) son l'os i el pes de cada
+    // influencia; un pes 0 ignora l'influencia i un vertex amb els quatre pesos
+    // a 0 es copia sense transformar. Els quaternions s'alineen amb
+    // el primer os (cami curt) abans de barrejar i el resultat es normalitza.
+    // normals/outNormals son opcionals (buits o de mida n).
+    static void SkinMany(std::span<const DualQuatT> palette,
+                         std::span<const Vec3T<T>> positions,
+                         std::span<const std::uint16_t> indices,
+                         std::span<const T> weights,
+                         std::span<Vec3T<T>> outPositions,
+                         std::span<const Vec3T<T>> normals = {},
+                         std::span<Vec3T<T>> outNormals = {});
+};
+
+extern template struct DualQuatT<float>;
+extern template struct DualQuatT<double>;
+
+using DualQuat = DualQuatT<double>;
+using DualQuatf = DualQuatT<float>;
@@ -0,0 +1,138 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include "Quat.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Arena lineal per als buffers temporals d'un frame. Allocate nomes avanca un
+// punter dins d'un bloc alineat a 64 bytes; Reset ho allibera tot de cop
+// (sense destructors). Si un frame no hi cap, s'encadena un bloc nou i el
+// seguent Reset els fusiona en un de sol amb la capacitat total: a partir
+// d'aqui el bucle del frame no crida malloc ni free.
+class FrameArena
+{
+public:
+    static constexpr std::size_t Alignment = 64;
+
+    explicit FrameArena(std::size_t capacity = std::size_t(1) << 20);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Bytes alineats a align (potencia de 2; si no, std::invalid_argument).
+    // La memoria es valida fins al seguent Reset.
+    void* Allocate(std::size_t bytes, std::size_t align = Alignment);
+
+    // n objectes alineats a 64 bytes. AllocateArray els construeix per defecte
+    // (com std::vector); AllocateUninitialized no els inicialitza, per a
+    // buffers de sortida que un kernel sobreescriu sencers.
+    template <typename U>
+    std::span<U> AllocateArray(std::size_t n)
+    {
+        std::span<U> out = AllocateUninitialized<U>(n);
+        // Copia d'un prototip: evita un constructor per element (rep stos)
+        std::uninitialized_fill(out.begin(), out.end(), U{});
+        return out;
+    }
+
+    template <typename U>
+    std::span<U> AllocateUninitialized(std::size_t n)
+    {
+        static_assert(std::is_trivially_destructible_v<U> && std::is_trivially_copyable_v<U>,
+                      "Reset no crida destructors");
+        if (n > static_cast<std::size_t>(-1) / sizeof(U)) {
+            throw std::bad_alloc();
+        }
+        return { static_cast<U*>(Allocate(n * sizeof(U), std::max(Alignment, alignof(U)))), n };
+    }
+
+    void Reset();
+
+    // Bytes ocupats en aquest frame (inclou el farciment d'alineacio)
+    std::size_t Used() const { return m_usedBefore + m_offset; }
+    std::size_t Capacity() const;
+    std::size_t BlockCount() const { return m_blocks.size(); }
+
+private:
+    struct Block
+    {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    void AddBlock(std::size_t size);
+    void FreeBlocks();
+
+    std::vector<Block> m_blocks;
+    std::size_t m_offset = 0;       // dins de l'ultim bloc
+    std::size_t m_usedBefore = 0;   // ocupat als blocs anteriors
+};
+
+// Contenidors SoA sobre l'arena: un array per component, cadascun alineat a
+// 64 bytes, que es poden passar directament a les versions SoA dels kernels
+// (TransformPoints, RotateMany, ProjectToNDC...). Son vistes: no posseeixen
+// la memoria, que es de l'arena, i Allocate no inicialitza els arrays.
+// Load/Store copien des de / cap a AoS i llancen std::invalid_argument si
+// les mides no coincideixen.
+template <typename T>
+struct Vec3SoAT
+{
+    std::span<T> x, y, z;
+
+    static Vec3SoAT Allocate(FrameArena& arena, std::size_t n);
+
+    std::size_t Size() const { return x.size(); }
+    Vec3T<T> Get(std::size_t i) const { return { x[i], y[i], z[i] }; }
+    void Set(std::size_t i, const Vec3T<T>& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+    void Load(std::span<const Vec3T<T>> in);
+    void Store(std::span<Vec3T<T>> out) const;
+};
+
+template <typename T>
+struct QuatSoAT
+{
+    std::span<T> s, x, y, z;
+
+    static QuatSoAT Allocate(FrameArena& arena, std::size_t n);
+
+    std::size_t Size() const { return s.size(); }
+    QuatT<T> Get(std::size_t i) const { return { s[i], x[i], y[i], z[i] }; }
+    void Set(std::size_t i, const QuatT<T>& q) { s[i] = q.s; x[i] = q.x; y[i] = q.y; z[i] = q.z; }
+    void Load(std::span<const QuatT<T>> in);
+    void Store(std::span<QuatT<T>> out) const;
+};
+
+// m[k][i] es l'element k (row-major) de la matriu i
+template <typename T>
+struct Matrix4x4SoAT
+{
+    std::span<T> m[16];
+
+    static Matrix4x4SoAT Allocate(FrameArena& arena, std::size_t n);
+
+    std::size_t Size() const { return m[0].size(); }
+    Matrix4x4T<T> Get(std::size_t i) const;
+    void Set(std::size_t i, const Matrix4x4T<T>& M);
+    void Load(std::span<const Matrix4x4T<T>> in);
+    void Store(std::span<Matrix4x4T<T>> out) const;
+};
+
+extern template struct Vec3SoAT<float>;
+extern template struct Vec3SoAT<double>;
+extern template struct QuatSoAT<float>;
+extern template struct QuatSoAT<double>;
+extern template struct Matrix4x4SoAT<float>;
+extern template struct Matrix4x4SoAT<double>;
+
+using Vec3SoA = Vec3SoAT<double>;
+using Vec3SoAf = Vec3SoAT<float>;
+using QuatSoA = QuatSoAT<double>;
+using QuatSoAf = QuatSoAT<float>;
+using Matrix4x4SoA = Matrix4x4SoAT<double>;
+using Matrix4x4SoAf = Matrix4x4SoAT<float>;
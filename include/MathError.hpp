@@ -0,0 +1,38 @@
+#pragma once
+
+// Errors de validacio com a valor, per als camins que no poden llancar
+// excepcions (bucles calents). Alternativa C++20 a std::expected.
+enum class MathError
+{
+    None = 0,
+    NotAffine,
+    NotRotation,
+    ZeroNorm,
+    Singular
+};
+
+inline const char* ToString(MathError e)
+{
+    switch (e) {
+    case MathError::NotAffine: return "La matriu no es afi";
+    case MathError::NotRotation: return "La matriu no es una rotacio";
+    case MathError::ZeroNorm: return "Norma zero";
+    case MathError::Singular: return "La matriu es singular";
+    default: return "Cap error";
+    }
+}
+
+template <typename V>
+struct Expected
+{
+    V value{};
+    MathError error = MathError::None;
+
+    Expected(const V& v) : value(v) {}
+    Expected(MathError e) : error(e) {}
+
+    bool has_value() const { return error == MathError::None; }
+    explicit operator bool() const { return has_value(); }
+    const V& operator*() const { return value; }
+    const V* operator->() const { return &value; }
+};
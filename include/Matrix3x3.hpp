@@ -1,51 +1,137 @@
 #pragma once
+#include "MatrixExpr.hpp"
 #include <vector>
 #include <cstddef>
 #include <cmath>
+#include <type_traits>
 
-struct Vec3 
+// Els tipus matematics son plantilles sobre l'escalar (float o double).
+// Els noms sense sufix (Vec3, Matrix3x3, ...) son la versio double; la
+// versio float porta el sufix f (Vec3f, Matrix3x3f, ...).
+// El nucli aritmetic (productes, transposades, identitats...) es constexpr i
+// viu al header: les taules constants es pleguen en temps de compilacio i
+// les crides es poden fer inline. Les funcions amb trigonometria, arrels o
+// validacio es queden als .cpp.
+
+// Tolerancia numerica segons la precisio de l'escalar
+template <typename T>
+constexpr T Tol() { return std::is_same_v<T, float> ? T(1e-4) : T(1e-6); }
+
+template <typename T>
+struct Vec3T 
 {
-    double x = 0, y = 0, z = 0;
+    T x = 0, y = 0, z = 0;
+
+    static constexpr T Dot(const Vec3T& a, const Vec3T& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+    static constexpr Vec3T Cross(const Vec3T& a, const Vec3T& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+    T Norm() const;
+    Vec3T Normalize() const;
 
-    static double Dot(const Vec3& a, const Vec3& b);
-    static Vec3 Cross(const Vec3& a, const Vec3& b);
-    double Norm() const;
-    Vec3 Normalize() const;
+    template <typename U>
+    Vec3T<U> Cast() const { return { static_cast<U>(x), static_cast<U>(y), static_cast<U>(z) }; }
 };
 
-struct Matrix3x3 
+template <typename T>
+struct Matrix3x3T 
 {
     // Row-major
-    double m[9] = { 0 };
+    T m[9] = { 0 };
 
-    static Matrix3x3 Identity();
-    double& At(std::size_t i, std::size_t j) { return m[i * 3 + j]; }
-    double  At(std::size_t i, std::size_t j) const { return m[i * 3 + j]; }
+    static constexpr Matrix3x3T Identity()
+    {
+        Matrix3x3T I;
+        I.m[0] = 1; I.m[4] = 1; I.m[8] = 1;
+        return I;
+    }
+    constexpr T& At(std::size_t i, std::size_t j) { return m[i * 3 + j]; }
+    constexpr T  At(std::size_t i, std::size_t j) const { return m[i * 3 + j]; }
 
-    Vec3 Multiply(const Vec3& x) const;
-    Matrix3x3 Multiply(const Matrix3x3& B) const;
+    // y = A * x
+    constexpr Vec3T<T> Multiply(const Vec3T<T>& x) const
+    {
+        return { At(0, 0) * x.x + At(0, 1) * x.y + At(0, 2) * x.z,
+                 At(1, 0) * x.x + At(1, 1) * x.y + At(1, 2) * x.z,
+                 At(2, 0) * x.x + At(2, 1) * x.y + At(2, 2) * x.z };
+    }
+    constexpr Matrix3x3T Multiply(const Matrix3x3T& B) const
+    {
+        Matrix3x3T C;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                T s = 0;
+                for (int k = 0; k < 3; ++k) {
+                    s += At(i, k) * B.At(k, j);
+                }
+                C.At(i, j) = s;
+            }
+        }
+        return C;
+    }
 
-    Vec3 operator*(const Vec3& x) const
+    constexpr Vec3T<T> operator*(const Vec3T<T>& x) const
     {
         return Multiply(x);
     }
-    Matrix3x3 operator*(const Matrix3x3& B) const
+    constexpr T Det() const
     {
-        return Multiply(B);
+        const T a = At(0, 0), b = At(0, 1), c = At(0, 2);
+        const T d = At(1, 0), e = At(1, 1), f = At(1, 2);
+        const T g = At(2, 0), h = At(2, 1), i = At(2, 2);
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    }
+    constexpr Matrix3x3T Transposed() const
+    {
+        Matrix3x3T R;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                R.At(i, j) = At(j, i);
+        return R;
+    }
+    constexpr T Trace() const
+    {
+        return At(0, 0) + At(1, 1) + At(2, 2);
     }
-
-    double Det() const;
-    Matrix3x3 Transposed() const;
-    double Trace() const;
 
     bool IsRotation() const;
-    static Matrix3x3 RotationAxisAngle(const Vec3& u, double phi);
-    void ToAxisAngle(Vec3& axis, double& angle) const;
-    Vec3 Rotate(const Vec3& v) const;
+    static Matrix3x3T RotationAxisAngle(const Vec3T<T>& u, T phi);
+    void ToAxisAngle(Vec3T<T>& axis, T& angle) const;
+    Vec3T<T> Rotate(const Vec3T<T>& v) const;
+
+    static Matrix3x3T FromEulerZYX(T yaw, T pitch, T roll);
+    void ToEulerZYX(T& yaw, T& pitch, T& roll) const;
 
-    static Matrix3x3 FromEulerZYX(double yaw, double pitch, double roll);
-    void ToEulerZYX(double& yaw, double& pitch, double& roll) const;
+    static Matrix3x3T RotateFromTo(const Vec3T<T>& u, const Vec3T<T>& v);
+    static Matrix3x3T RotateToTarget(const Matrix3x3T& initialRot, const Matrix3x3T& finalRot);
 
-    static Matrix3x3 RotateFromTo(const Vec3& u, const Vec3& v);
-    static Matrix3x3 RotateToTarget(const Matrix3x3& initialRot, const Matrix3x3& finalRot);
+    template <typename U>
+    Matrix3x3T<U> Cast() const
+    {
+        Matrix3x3T<U> R;
+        for (int k = 0; k < 9; ++k) R.m[k] = static_cast<U>(m[k]);
+        return R;
+    }
+};
+
+// A * B (* C ...) es una expressio mandrosa (MatrixExpr.hpp)
+template <typename T>
+struct MatrixTraits<Matrix3x3T<T>>
+{
+    static constexpr bool IsMatrix = true;
+    using Vec = Vec3T<T>;
 };
+
+extern template struct Vec3T<float>;
+extern template struct Vec3T<double>;
+extern template struct Matrix3x3T<float>;
+extern template struct Matrix3x3T<double>;
+
+using Vec3 = Vec3T<double>;
+using Vec3f = Vec3T<float>;
+using Matrix3x3 = Matrix3x3T<double>;
+using Matrix3x3f = Matrix3x3T<float>;
@@ -1,58 +1,262 @@
 #pragma once
 #include "Matrix3x3.hpp"
 #include "Quat.hpp"
+#include "MathError.hpp"
 #include <iostream>
+#include <span>
+#include <type_traits>
 
-struct Vec4
+template <typename T>
+struct Vec4T
 {
-    double x = 0, y = 0, z = 0, w = 0;
+    T x = 0, y = 0, z = 0, w = 0;
 
-    Vec4() = default;
-    Vec4(double _x, double _y, double _z, double _w) : x(_x), y(_y), z(_z), w(_w) {}
-    Vec4(const Vec3& v, double _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
+    constexpr Vec4T() = default;
+    constexpr Vec4T(T _x, T _y, T _z, T _w) : x(_x), y(_y), z(_z), w(_w) {}
+    constexpr Vec4T(const Vec3T<T>& v, T _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
 };
 
-struct Matrix4x4
+template <typename T>
+struct Matrix4x4T
 {
     // Row-major: m[row * 4 + col]
-    double m[16] = { 0 };
+    T m[16] = { 0 };
 
-    static Matrix4x4 Identity();
-    double& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
-    double  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
+    static constexpr Matrix4x4T Identity()
+    {
+        Matrix4x4T I;
+        I.m[0] = 1; I.m[5] = 1; I.m[10] = 1; I.m[15] = 1;
+        return I;
+    }
+    constexpr T& At(std::size_t i, std::size_t j) { return m[i * 4 + j]; }
+    constexpr T  At(std::size_t i, std::size_t j) const { return m[i * 4 + j]; }
 
-    Matrix4x4 Multiply(const Matrix4x4& B) const;
-    Vec4 Multiply(const Vec4& v) const;
+    // En temps de compilacio es fa el producte escalar; en execucio es crida
+    // el kernel SIMD seleccionat (MultiplyDispatch). Scalar, SSE2 i AVX2 sumen
+    // en el mateix ordre i donen el mateix resultat bit a bit; FMA arrodoneix
+    // un cop per multiplicacio-suma i pot diferir en un ulp per element d'una
+    // taula constexpr.
+    // En execucio Multiply NO s'inlinea: el kernel es tria segons
+    // GetSimdLevel() i els kernels AVX2/FMA es compilen amb atributs de target,
+    // que no es poden inlinear en codi generic sense trencar el binari en CPUs
+    // sense AVX2. El cost es una crida per producte; per a bucles calents hi
+    // ha MultiplyAffine (inline, escalar) i les versions en lot.
+    constexpr Matrix4x4T Multiply(const Matrix4x4T& B) const
+    {
+        if (std::is_constant_evaluated()) {
+            Matrix4x4T C;
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                    T sum = 0;
+                    for (int k = 0; k < 4; ++k) {
+                        sum += m[i * 4 + k] * B.m[k * 4 + j];
+                    }
+                    C.m[i * 4 + j] = sum;
+                }
+            }
+            return C;
+        }
+        return MultiplyDispatch(B);
+    }
+    constexpr Vec4T<T> Multiply(const Vec4T<T>& v) const
+    {
+        if (std::is_constant_evaluated()) {
+            const T in[4] = { v.x, v.y, v.z, v.w };
+            T r[4] = {};
+            for (int i = 0; i < 4; ++i) {
+                r[i] = m[i * 4 + 0] * in[0] + m[i * 4 + 1] * in[1] + m[i * 4 + 2] * in[2] + m[i * 4 + 3] * in[3];
+            }
+            return Vec4T<T>(r[0], r[1], r[2], r[3]);
+        }
+        return MultiplyDispatch(v);
+    }
+    constexpr Vec4T<T> operator*(const Vec4T<T>& v) const
+    {
+        return Multiply(v);
+    }
+    Matrix4x4T MultiplyDispatch(const Matrix4x4T& B) const;
+    Vec4T<T> MultiplyDispatch(const Vec4T<T>& v) const;
+
+    // Producte de dues matrius afins: nomes calcula les tres primeres files
+    // (36 productes) i posa la fila inferior a [0 0 0 1]. No comprova IsAffine().
+    constexpr Matrix4x4T MultiplyAffine(const Matrix4x4T& B) const
+    {
+        Matrix4x4T C;
+        for (int i = 0; i < 3; ++i) {
+            const T a0 = At(i, 0), a1 = At(i, 1), a2 = At(i, 2);
+            for (int j = 0; j < 4; ++j) {
+                C.At(i, j) = a0 * B.At(0, j) + a1 * B.At(1, j) + a2 * B.At(2, j);
+            }
+            C.At(i, 3) += At(i, 3);
+        }
+        C.At(3, 3) = 1;
+        return C;
+    }
 
     bool IsAffine() const;
 	
     // Transformacions de punts i vectors
-	Vec3 TransformPoint(const Vec3& p) const;
-	Vec3 TransformVector(const Vec3& v) const;
+	Vec3T<T> TransformPoint(const Vec3T<T>& p) const;
+	Vec3T<T> TransformVector(const Vec3T<T>& v) const;
+
+    // Transformacions en lot (AoS i SoA). Si la matriu es afi no es divideix per w.
+    // in i out poden ser el mateix buffer.
+    void TransformPoints(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const;
+    void TransformVectors(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const;
+    void TransformPoints(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                         std::span<T> ox, std::span<T> oy, std::span<T> oz) const;
+    void TransformVectors(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                          std::span<T> ox, std::span<T> oy, std::span<T> oz) const;
+
+    // Projeccio a NDC: sempre divideix per w, en la precisio de T (sense el
+    // llindar de TransformPoint). w <= 0 vol dir punt darrere la camera; la
+    // versio SoA pot retornar w per descartar-los. Amb AVX2 en double.
+    Vec3T<T> ProjectToNDC(const Vec3T<T>& p) const;
+    void ProjectToNDC(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const;
+    void ProjectToNDC(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                      std::span<T> ox, std::span<T> oy, std::span<T> oz, std::span<T> ow = {}) const;
+
+    // Matriu de normals (M3x3^-1)^T. NormalMatrix en dona la direccio amb la
+    // matriu de cofactors, sense dividir pel determinant (nomes en conserva el
+    // signe, perque un mirall no giri les normals). NormalMatrixExact divideix
+    // per det i llanca std::runtime_error si la part 3x3 es singular. Les dues
+    // llancen si la matriu no es afi.
+    Matrix3x3T<T> NormalMatrix() const;
+    Matrix3x3T<T> NormalMatrixExact() const;
+
+    // Normals en lot: NormalMatrix() * n renormalitzat (una longitud nul.la
+    // dona zero). in i out poden coincidir. Amb AVX2 renormalitza amb rsqrt
+    // i passos de Newton: |n'| - 1 <= 1e-12 en double i <= 1e-6 en float.
+    void TransformNormals(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const;
+    void TransformNormals(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                          std::span<T> ox, std::span<T> oy, std::span<T> oz) const;
 
     // Statics
-    static Matrix4x4 Translate(const Vec3& t);
-    static Matrix4x4 Scale(const Vec3& s);
-    static Matrix4x4 Rotate(const Matrix3x3& R);
-    static Matrix4x4 Rotate(const Quat& q);
-    static Matrix4x4 FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s);
-    static Matrix4x4 FromTRS(const Vec3& t, const Quat& q, const Vec3& s);
+    static constexpr Matrix4x4T Translate(const Vec3T<T>& t)
+    {
+        Matrix4x4T M = Identity();
+        M.At(0, 3) = t.x;
+        M.At(1, 3) = t.y;
+        M.At(2, 3) = t.z;
+        return M;
+    }
+    static constexpr Matrix4x4T Scale(const Vec3T<T>& s)
+    {
+        Matrix4x4T M = Identity();
+        M.At(0, 0) = s.x;
+        M.At(1, 1) = s.y;
+        M.At(2, 2) = s.z;
+        return M;
+    }
+    static constexpr Matrix4x4T Rotate(const Matrix3x3T<T>& R)
+    {
+        Matrix4x4T M = Identity();
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                M.At(i, j) = R.At(i, j);
+            }
+        }
+        return M;
+    }
+    static Matrix4x4T Rotate(const QuatT<T>& q);
+    static Matrix4x4T FromTRS(const Vec3T<T>& t, const Matrix3x3T<T>& R, const Vec3T<T>& s);
+    static Matrix4x4T FromTRS(const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s);
+
+    // Camera (convencio OpenGL: vista dreta mirant cap a -Z, NDC en [-1, 1]^3).
+    // Llancen std::invalid_argument amb parametres degenerats.
+    static Matrix4x4T Perspective(T fovY, T aspect, T zNear, T zFar);
+    static Matrix4x4T Orthographic(T left, T right, T bottom, T top, T zNear, T zFar);
+    static Matrix4x4T LookAt(const Vec3T<T>& eye, const Vec3T<T>& target, const Vec3T<T>& up);
 
 	// Inverses
-    Matrix4x4 InverseTR() const;
-	Matrix4x4 InverseTRS() const;
+    Matrix4x4T InverseTR() const;
+	Matrix4x4T InverseTRS() const;
+    // Inversa general per cofactors, valida tambe per a matrius projectives.
+    // Inverse llanca si la matriu es singular.
+    T Det() const;
+    Matrix4x4T Inverse() const;
+    Expected<Matrix4x4T> TryInverse() const;
+    // En lot. InverseMany deixa a zero les singulars i retorna MathError::Singular;
+    // InverseTRSMany valida tot el lot (afi) abans de comencar.
+    static MathError InverseMany(std::span<const Matrix4x4T> in, std::span<Matrix4x4T> out);
+    static void InverseTRSMany(std::span<const Matrix4x4T> in, std::span<Matrix4x4T> out);
 
     // Getters de components
-    Vec3 GetTranslation() const;
-	Matrix3x3 GetRotation() const;
-	Quat GetRotationQuat() const;
-	Vec3 GetScale() const;
-    Matrix3x3 GetRotationScale() const;
+    Vec3T<T> GetTranslation() const;
+	Matrix3x3T<T> GetRotation() const;
+	QuatT<T> GetRotationQuat() const;
+	Vec3T<T> GetScale() const;
+    Matrix3x3T<T> GetRotationScale() const;
 
 	// Setters de components
-	void SetTranslation(const Vec3& t);
-	void SetRotation(const Matrix3x3& R);
-	void SetRotation(const Quat& q);
-	void SetScale(const Vec3& s);
-	void SetRotationScale(const Matrix3x3& RS);
-};
\ No newline at end of file
+	void SetTranslation(const Vec3T<T>& t);
+	void SetRotation(const Matrix3x3T<T>& R);
+	void SetRotation(const QuatT<T>& q);
+	void SetScale(const Vec3T<T>& s);
+	void SetRotationScale(const Matrix3x3T<T>& RS);
+
+    // Descomposicio TRS en una sola passada: normes de columna calculades un cop
+    // i sense revalidar. No comprova que la part 3x3 no tingui cisalla.
+    // Amb un mirall (det < 0) l'escala x surt negativa i q es una rotacio, de
+    // manera que FromTRS(t, q, s) reprodueix la matriu. Decompose llanca
+    // std::runtime_error si la matriu no es afi o alguna escala es ~0 (Try
+    // retorna NotAffine / Singular); DecomposeMany valida tot el lot abans de
+    // comencar. La versio Unchecked suposa escales no nul.les: si no, q no es
+    // unitari. CheckDecompose es la validacio comuna de tots els camins
+    // comprovats (None, NotAffine o Singular), per als lots d'altres moduls.
+    MathError CheckDecompose() const;
+    void Decompose(Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s) const;
+    void DecomposeUnchecked(Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s) const;
+    MathError TryDecompose(Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s) const;
+    static void DecomposeMany(std::span<const Matrix4x4T> M, std::span<Vec3T<T>> t,
+                              std::span<QuatT<T>> q, std::span<Vec3T<T>> s);
+
+    // Versions sense validacio per a bucles calents: suposen IsAffine() i no
+    // llancen mai. La validacio es fa un sol cop a l'entrada de l'API.
+    Vec3T<T> GetTranslationUnchecked() const;
+    Matrix3x3T<T> GetRotationUnchecked() const;
+    QuatT<T> GetRotationQuatUnchecked() const;
+    Vec3T<T> GetScaleUnchecked() const;
+    Matrix3x3T<T> GetRotationScaleUnchecked() const;
+    void SetTranslationUnchecked(const Vec3T<T>& t);
+    void SetRotationUnchecked(const Matrix3x3T<T>& R);
+    void SetRotationUnchecked(const QuatT<T>& q);
+    void SetScaleUnchecked(const Vec3T<T>& s);
+    void SetRotationScaleUnchecked(const Matrix3x3T<T>& RS);
+
+    // Versions que retornen l'error com a valor en lloc de llancar
+    Expected<Vec3T<T>> TryGetTranslation() const;
+    Expected<Matrix3x3T<T>> TryGetRotation() const;
+    Expected<QuatT<T>> TryGetRotationQuat() const;
+    Expected<Vec3T<T>> TryGetScale() const;
+    Expected<Matrix3x3T<T>> TryGetRotationScale() const;
+    MathError TrySetTranslation(const Vec3T<T>& t);
+    MathError TrySetRotation(const Matrix3x3T<T>& R);
+    MathError TrySetRotation(const QuatT<T>& q);
+    MathError TrySetScale(const Vec3T<T>& s);
+    MathError TrySetRotationScale(const Matrix3x3T<T>& RS);
+
+    template <typename U>
+    Matrix4x4T<U> Cast() const
+    {
+        Matrix4x4T<U> R;
+        for (int k = 0; k < 16; ++k) R.m[k] = static_cast<U>(m[k]);
+        return R;
+    }
+};
+
+// A * B (* C ...) es una expressio mandrosa (MatrixExpr.hpp)
+template <typename T>
+struct MatrixTraits<Matrix4x4T<T>>
+{
+    static constexpr bool IsMatrix = true;
+    using Vec = Vec4T<T>;
+};
+
+extern template struct Matrix4x4T<float>;
+extern template struct Matrix4x4T<double>;
+
+using Vec4 = Vec4T<double>;
+using Vec4f = Vec4T<float>;
+using Matrix4x4 = Matrix4x4T<double>;
+using Matrix4x4f = Matrix4x4T<float>;
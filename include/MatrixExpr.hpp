@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Productes encadenats avaluats de forma mandrosa (expression templates).
+// A * B * C no calcula res: construeix un arbre amb les fulles. Quan l'arbre
+// es converteix a matriu es fan els n - 1 productes (amb matrius quadrades
+// totes les associacions costen igual); quan es multiplica per un vector
+// s'avalua de dreta a esquerra com a productes matriu-vector, sense cap
+// matriu temporal: A * B * C * v = A (B (C v)).
+//
+// Les matrius amb nom es guarden per referencia (MatRef) i els temporals per
+// valor (MatVal), de manera que auto E = A * Make() no penja. Com amb
+// std::string_view, E no pot sobreviure a A.
+//
+// El producte es comporta com una matriu per a l'us habitual: es converteix
+// implicitament i exposa Eval(), At, Det, Trace, Transposed i Inverse. Les
+// plantilles que dedueixen el tipus de matriu (f(const Matrix3x3T<T>&)) no
+// accepten el node: cal passar-hi (A * B).Eval().
+
+// Cada tipus de matriu declara el vector sobre el qual actua
+template <typename M>
+struct MatrixTraits
+{
+    static constexpr bool IsMatrix = false;
+};
+
+template <typename M>
+concept MatrixType = MatrixTraits<M>::IsMatrix;
+
+// Fulla: una matriu amb nom (l'expressio no la pot sobreviure)
+template <typename M>
+struct [[nodiscard]] MatRef
+{
+    using Matrix = M;
+    using Vec = typename MatrixTraits<M>::Vec;
+
+    const M& m;
+
+    constexpr const M& Eval() const { return m; }
+    constexpr Vec Apply(const Vec& v) const { return m.Multiply(v); }
+};
+
+// Fulla: un temporal, copiat dins el node
+template <typename M>
+struct [[nodiscard]] MatVal
+{
+    using Matrix = M;
+    using Vec = typename MatrixTraits<M>::Vec;
+
+    M m;
+
+    constexpr const M& Eval() const { return m; }
+    constexpr Vec Apply(const Vec& v) const { return m.Multiply(v); }
+};
+
+// Node intern: lhs * rhs (cada costat es una fulla o un altre producte)
+template <typename L, typename R>
+struct [[nodiscard]] MatProduct
+{
+    using Matrix = typename L::Matrix;
+    using Vec = typename L::Vec;
+    static_assert(std::is_same_v<Matrix, typename R::Matrix>, "Producte de matrius de tipus diferent");
+
+    L lhs;
+    R rhs;
+
+    constexpr Matrix Eval() const { return lhs.Eval().Multiply(rhs.Eval()); }
+    constexpr Vec Apply(const Vec& v) const { return lhs.Apply(rhs.Apply(v)); }
+    constexpr operator Matrix() const { return Eval(); }
+
+    // Membres habituals de la matriu resultant (avaluen el producte)
+    constexpr auto At(std::size_t i, std::size_t j) const { return Eval().At(i, j); }
+    constexpr auto Det() const { return Eval().Det(); }
+    constexpr auto Trace() const { return Eval().Trace(); }
+    constexpr Matrix Transposed() const { return Eval().Transposed(); }
+    Matrix Inverse() const { return Eval().Inverse(); }
+};
+
+template <typename E>
+struct IsMatProduct : std::false_type {};
+template <typename L, typename R>
+struct IsMatProduct<MatProduct<L, R>> : std::true_type {};
+
+template <typename E>
+concept MatExpr = IsMatProduct<E>::value;
+
+template <typename A>
+concept MatOperand = MatrixType<std::remove_cvref_t<A>> || MatExpr<std::remove_cvref_t<A>>;
+
+// Matriu amb nom -> MatRef; temporal -> MatVal; producte -> copia del node
+template <typename A>
+constexpr auto MatNode(A&& a)
+{
+    using D = std::remove_cvref_t<A>;
+    if constexpr (MatExpr<D>) {
+        return D(std::forward<A>(a));
+    }
+    else if constexpr (std::is_lvalue_reference_v<A>) {
+        return MatRef<D>{ a };
+    }
+    else {
+        return MatVal<D>{ std::move(a) };
+    }
+}
+
+template <MatOperand A, MatOperand B>
+constexpr auto operator*(A&& a, B&& b)
+{
+    return MatProduct<decltype(MatNode(std::forward<A>(a))), decltype(MatNode(std::forward<B>(b)))>{
+        MatNode(std::forward<A>(a)), MatNode(std::forward<B>(b)) };
+}
+
+template <MatExpr E>
+constexpr typename E::Vec operator*(const E& e, const typename E::Vec& v)
+{
+    return e.Apply(v);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include "ThreadPool.hpp"
+#include <span>
+#include <type_traits>
+
+// Transformacions en lot repartides entre fils. Cada tros crida el kernel
+// serie (SIMD) de Matrix4x4 sobre el seu rang, aixi que el resultat es
+// identic al de TransformPoints/TransformVectors sigui quin sigui el nombre
+// de fils. grain = elements per tros (0: trossos de ~128 KiB d'entrada i
+// sortida, perque cada tros visqui a la L2). in i out poden coincidir.
+// L'escalar es dedueix nomes de la matriu: els spans accepten vectors.
+template <typename T>
+using NonDeduced = std::type_identity_t<T>;
+
+template <typename T>
+void TransformPointsParallel(const Matrix4x4T<T>& M, std::span<const Vec3T<NonDeduced<T>>> in, std::span<Vec3T<NonDeduced<T>>> out,
+                             ThreadPool& pool = ThreadPool::Default(), std::size_t grain = 0);
+template <typename T>
+void TransformVectorsParallel(const Matrix4x4T<T>& M, std::span<const Vec3T<NonDeduced<T>>> in, std::span<Vec3T<NonDeduced<T>>> out,
+                              ThreadPool& pool = ThreadPool::Default(), std::size_t grain = 0);
+template <typename T>
+void TransformPointsParallel(const Matrix4x4T<T>& M, std::span<const NonDeduced<T>> x, std::span<const NonDeduced<T>> y, std::span<const NonDeduced<T>> z,
+                             std::span<NonDeduced<T>> ox, std::span<NonDeduced<T>> oy, std::span<NonDeduced<T>> oz,
+                             ThreadPool& pool = ThreadPool::Default(), std::size_t grain = 0);
+template <typename T>
+void TransformVectorsParallel(const Matrix4x4T<T>& M, std::span<const NonDeduced<T>> x, std::span<const NonDeduced<T>> y, std::span<const NonDeduced<T>> z,
+                              std::span<NonDeduced<T>> ox, std::span<NonDeduced<T>> oy, std::span<NonDeduced<T>> oz,
+                              ThreadPool& pool = ThreadPool::Default(), std::size_t grain = 0);
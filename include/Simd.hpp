@@ -0,0 +1,62 @@
+#pragma once
+
+// Seleccio en temps d'execucio dels kernels SIMD (x86: SSE2, AVX2, AVX2+FMA).
+// Els kernels es compilen amb atributs de target, de manera que el binari
+// continua funcionant en CPUs sense AVX2: el nivell es decideix amb CPUID.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LAB3_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define LAB3_SIMD_X86 0
+#endif
+
+#if LAB3_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define LAB3_TARGET_SSE2 __attribute__((target("sse2")))
+#define LAB3_TARGET_AVX2 __attribute__((target("avx2")))
+#define LAB3_TARGET_FMA  __attribute__((target("avx2,fma")))
+#define LAB3_TARGET_F16C __attribute__((target("avx2,f16c")))
+#else
+// MSVC permet fer servir qualsevol intrinsic sense /arch
+#define LAB3_TARGET_SSE2
+#define LAB3_TARGET_AVX2
+#define LAB3_TARGET_FMA
+#define LAB3_TARGET_F16C
+#endif
+
+enum class SimdLevel
+{
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    FMA = 3   // AVX2 + FMA3
+};
+
+// Nivell maxim que suporten la CPU i el sistema operatiu
+SimdLevel DetectSimdLevel();
+
+// Nivell actiu. Per defecte es el detectat; SetSimdLevel permet forcar-ne un
+// d'inferior (p. ex. per comparar kernels amb l'escalar als tests).
+SimdLevel GetSimdLevel();
+void SetSimdLevel(SimdLevel level);
+
+const char* ToString(SimdLevel level);
+
+// Conversio float <-> half per maquinari (F16C). Tots els processadors amb
+// AVX2 coneguts la tenen, pero es comprova a part.
+bool HasF16C();
+
+#if LAB3_SIMD_X86
+// Transposicio 4x4 de doubles en registres: a l'entrada r[i] es la fila i i a
+// la sortida r[j] es la columna j. Permet passar de dades AoS (una matriu o un
+// quaternio per registre) a un carril per element.
+LAB3_TARGET_AVX2 inline void Transpose4_AVX2(__m256d& r0, __m256d& r1, __m256d& r2, __m256d& r3)
+{
+    const __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    const __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+#endif
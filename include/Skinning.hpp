@@ -0,0 +1,53 @@
+#pragma once
+#include "Affine3x4.hpp"
+#include "ThreadPool.hpp"
+#include <cstdint>
+#include <span>
+
+// Skinning per barreja lineal (LBS) sobre streams SoA. Cada vertex te fins a
+// 4 influencies: indices[4*i+k] i weights[4*i+k], k = 0..3 (pes 0 = sense us).
+// La paleta es d'Affine3x4 (48 bytes per os en double en lloc de 64).
+
+template <typename T>
+struct SkinStreamsT
+{
+    std::span<const T> x, y, z;
+    std::span<const T> nx, ny, nz;           // opcionals: buits si no hi ha normals
+    std::span<const std::uint16_t> indices;  // 4 per vertex
+    std::span<const T> weights;              // 4 per vertex
+};
+
+template <typename T>
+struct SkinTargetsT
+{
+    std::span<T> x, y, z;
+    std::span<T> nx, ny, nz;                 // nomes si l'entrada te normals
+};
+
+template <typename T>
+struct SkinningT
+{
+    // palette[i] = bones[i] * inverseBind[i]. Llanca si alguna matriu no es afi.
+    static void BuildPalette(std::span<const Matrix4x4T<T>> bones, std::span<const Matrix4x4T<T>> inverseBind,
+                             std::span<Affine3x4T<T>> palette);
+
+    // out = (sum_k w_k * palette[idx_k]) * p. Les normals es transformen amb la
+    // part 3x3 de la mateixa matriu barrejada i no es renormalitzen. Valida
+    // mides i indexs un sol cop; en double amb AVX2 fa quatre vertexs per iteracio.
+    static void SkinLinear(std::span<const Affine3x4T<T>> palette, const SkinStreamsT<T>& in, const SkinTargetsT<T>& out);
+
+    // Igual, repartit en trossos de 'grain' vertexs (0: automatic) entre els fils
+    static void SkinLinearParallel(std::span<const Affine3x4T<T>> palette, const SkinStreamsT<T>& in,
+                                   const SkinTargetsT<T>& out, ThreadPool& pool = ThreadPool::Default(),
+                                   std::size_t grain = 0);
+};
+
+extern template struct SkinningT<float>;
+extern template struct SkinningT<double>;
+
+using SkinStreams = SkinStreamsT<double>;
+using SkinStreamsf = SkinStreamsT<float>;
+using SkinTargets = SkinTargetsT<double>;
+using SkinTargetsf = SkinTargetsT<float>;
+using Skinning = SkinningT<double>;
+using Skinningf = SkinningT<float>;
@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de fils amb robatori de feina (work stealing). Cada fil te la seva
+// cua: ParallelFor reparteix trossos contigus entre les cues i un fil que
+// acaba la seva roba trossos del davant de les cues dels altres. El fil que
+// crida tambe treballa i no retorna fins que s'han executat tots els trossos.
+class ThreadPool
+{
+public:
+    // threads = fils totals incloent-hi el que crida (0: hardware_concurrency)
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t Size() const { return m_threads.size() + 1; }
+
+    // Executa body(begin, end) sobre trossos de [0, n) de com a molt 'grain'
+    // elements (0: automatic). Els trossos son disjunts, aixi que si cada un
+    // escriu el seu rang de sortida el resultat no depen de la planificacio.
+    // La primera excepcio d'un tros es rellanca al fil que crida.
+    void ParallelFor(std::size_t n, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)>& body);
+
+    // Pool global compartit, creat en el primer us
+    static ThreadPool& Default();
+
+private:
+    struct Job;
+    struct Task
+    {
+        Job* job = nullptr;
+        std::size_t begin = 0, end = 0;
+    };
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool Pop(std::size_t self, Task& task);
+    bool Steal(std::size_t self, Task& task);
+    static void Execute(const Task& task);
+    void WorkerLoop(std::size_t self);
+
+    // Una cua per treballador mes una (l'ultima) per als fils externs
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<std::size_t> m_pending{ 0 };
+    bool m_stop = false;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include <cstdint>
+
+// Component de transformacio: guarda translacio, rotacio i escala per
+// separat i reconstrueix la Matrix4x4, la inversa i la matriu de normals
+// nomes quan es llegeixen despres d'un canvi. Cada setter incrementa
+// Version(); els getters comparen la versio amb la de la copia en cache.
+// Editar molts cops seguits nomes copia valors, i com que no es descompon la
+// matriu en cada setter (SetScale -> GetRotation -> GetScale...) no
+// s'acumula error.
+//
+// q ha de ser unitari, com a FromTRS. Els getters de matrius modifiquen la
+// cache: no es poden cridar des de diversos fils sobre el mateix objecte.
+template <typename T>
+class TransformT
+{
+public:
+    TransformT() = default;
+    TransformT(const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s) : m_t(t), m_q(q), m_s(s) {}
+
+    // Descompon M un sol cop (Matrix4x4::Decompose): llanca std::runtime_error
+    // si no es afi o alguna escala es ~0. Un mirall dona escala x negativa.
+    static TransformT FromMatrix(const Matrix4x4T<T>& M);
+
+    const Vec3T<T>& Translation() const { return m_t; }
+    const QuatT<T>& Rotation() const { return m_q; }
+    const Vec3T<T>& Scale() const { return m_s; }
+
+    void Set(const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s) { m_t = t; m_q = q; m_s = s; ++m_version; }
+    void SetTranslation(const Vec3T<T>& t) { m_t = t; ++m_version; }
+    void SetRotation(const QuatT<T>& q) { m_q = q; ++m_version; }
+    // Llanca std::invalid_argument si R no es una rotacio (Quat::FromMatrix3x3)
+    void SetRotation(const Matrix3x3T<T>& R);
+    void SetScale(const Vec3T<T>& s) { m_s = s; ++m_version; }
+
+    std::uint64_t Version() const { return m_version; }
+
+    // T * R * S. La referencia es valida fins al seguent setter.
+    const Matrix4x4T<T>& Matrix() const;
+    // S^-1 * R^T * T^-1, directament dels components (sense descomposar).
+    // Un eix amb escala ~0 dona una fila de zeros, com InverseTRS.
+    const Matrix4x4T<T>& Inverse() const;
+    // Matrix().NormalMatrix() (cofactors, sense dividir pel determinant)
+    const Matrix3x3T<T>& NormalMatrix() const;
+
+private:
+    Vec3T<T> m_t{ 0, 0, 0 };
+    QuatT<T> m_q;
+    Vec3T<T> m_s{ 1, 1, 1 };
+    std::uint64_t m_version = 1;
+
+    // Cache: valida si la versio coincideix (0 = mai calculada)
+    mutable Matrix4x4T<T> m_matrix;
+    mutable Matrix4x4T<T> m_inverse;
+    mutable Matrix3x3T<T> m_normal;
+    mutable std::uint64_t m_matrixVersion = 0;
+    mutable std::uint64_t m_inverseVersion = 0;
+    mutable std::uint64_t m_normalVersion = 0;
+};
+
+extern template class TransformT<float>;
+extern template class TransformT<double>;
+
+using Transform = TransformT<double>;
+using Transformf = TransformT<float>;
@@ -0,0 +1,65 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Jerarquia de transformacions (arbre pare/fill) guardada en arrays plans.
+// Els nodes estan ordenats de manera que el pare sempre te un index menor
+// que el fill, aixi UpdateWorld es un sol recorregut lineal. Nomes es
+// recalculen els nodes marcats com a bruts i els seus descendents: una
+// escena estatica no fa cap producte.
+template <typename T>
+struct TransformHierarchyT
+{
+    static constexpr std::size_t NoParent = static_cast<std::size_t>(-1);
+
+    // Afegeix un node amb transformacio local TRS. El pare ha d'existir
+    // (parent < Size()) o ser NoParent; si no, llanca std::invalid_argument.
+    std::size_t AddNode(std::size_t parent, const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s);
+    std::size_t AddNode(std::size_t parent);
+    void Reserve(std::size_t n);
+    void Clear();
+
+    std::size_t Size() const { return m_parent.size(); }
+    std::size_t Parent(std::size_t i) const { return m_parent.at(i); }
+
+    // Setters locals: marquen el node com a brut
+    void SetLocal(std::size_t i, const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s);
+    void SetTranslation(std::size_t i, const Vec3T<T>& t);
+    void SetRotation(std::size_t i, const QuatT<T>& q);
+    void SetScale(std::size_t i, const Vec3T<T>& s);
+
+    const Vec3T<T>& Translation(std::size_t i) const { return m_t.at(i); }
+    const QuatT<T>& Rotation(std::size_t i) const { return m_q.at(i); }
+    const Vec3T<T>& Scale(std::size_t i) const { return m_s.at(i); }
+
+    // Recalcula World = World(pare) * FromTRS(local) per als nodes bruts i
+    // els seus descendents. Retorna quants nodes s'han recalculat.
+    std::size_t UpdateWorld();
+    bool IsDirty() const { return m_firstDirty < Size(); }
+
+    // Matrius de mon; valides despres d'UpdateWorld
+    const Matrix4x4T<T>& World(std::size_t i) const { return m_world.at(i); }
+    const Matrix4x4T<T>& Local(std::size_t i) const { return m_local.at(i); }
+    std::span<const Matrix4x4T<T>> WorldMatrices() const { return m_world; }
+
+private:
+    void MarkDirty(std::size_t i);
+
+    std::vector<std::size_t> m_parent;
+    std::vector<Vec3T<T>> m_t;
+    std::vector<QuatT<T>> m_q;
+    std::vector<Vec3T<T>> m_s;
+    std::vector<Matrix4x4T<T>> m_local;
+    std::vector<Matrix4x4T<T>> m_world;
+    std::vector<std::uint8_t> m_dirty;
+    // Primer index brut: UpdateWorld comenca aqui i una escena neta no recorre res
+    std::size_t m_firstDirty = 0;
+};
+
+extern template struct TransformHierarchyT<float>;
+extern template struct TransformHierarchyT<double>;
+
+using TransformHierarchy = TransformHierarchyT<double>;
+using TransformHierarchyf = TransformHierarchyT<float>;
@@ -0,0 +1,123 @@
+#pragma once
+#include "Matrix4x4.hpp"
+#include "Quat.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+
+// Format binari per a pistes de transformacions precalculades. Un fitxer es
+// una capcalera de 64 bytes seguida d'un array de registres del mateix tipus
+// (Matrix4x4, Quat, Vec3 o TRSRecord, en float o double), tal com son a
+// memoria: el lector mapeja el fitxer (mmap / MapViewOfFile) i retorna un
+// span que els kernels en lot poden fer servir directament, sense copiar.
+// Les dades comencen a l'offset 64, de manera que queden alineades a 64 bytes.
+//
+// Capcalera (little-endian): magic "L3TS", versio, marca d'ordre de bytes,
+// tipus de registre, mida de l'escalar i del registre, nombre de registres,
+// offset de les dades i checksum de les dades (Fletcher de 64 bits sobre
+// paraules de 32 bits).
+
+template <typename T>
+struct TRSRecordT
+{
+    Vec3T<T> t;
+    QuatT<T> q;
+    Vec3T<T> s{ 1, 1, 1 };
+};
+
+constexpr std::uint32_t TransformStreamVersion = 1;
+
+// Checksum incremental de les dades (la mida ha de ser multiple de 4 bytes)
+struct StreamChecksum
+{
+    std::uint64_t sum1 = 0, sum2 = 0;
+
+    void Update(const void* data, std::size_t bytes);
+    std::uint64_t Value() const { return sum1 ^ (sum2 << 32 | sum2 >> 32); }
+};
+
+// Escriptura en streaming: Write afegeix registres al final i Close escriu
+// el nombre de registres i el checksum a la capcalera. El destructor tanca
+// si no s'ha fet (sense llancar). Llanca std::runtime_error si no pot
+// obrir o escriure el fitxer.
+template <typename R>
+class TransformStreamWriter
+{
+public:
+    explicit TransformStreamWriter(const std::string& path);
+    ~TransformStreamWriter();
+
+    TransformStreamWriter(const TransformStreamWriter&) = delete;
+    TransformStreamWriter& operator=(const TransformStreamWriter&) = delete;
+
+    void Write(std::span<const R> records);
+    void Write(const R& record) { Write(std::span<const R>(&record, 1)); }
+    void Close();
+
+    std::size_t Count() const { return m_count; }
+
+private:
+    std::ofstream m_out;
+    std::size_t m_count = 0;
+    StreamChecksum m_checksum;
+};
+
+// Fitxer mapejat nomes de lectura (POSIX o Windows)
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::byte* Data() const { return m_data; }
+    std::size_t Size() const { return m_size; }
+
+private:
+    const std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+// Lector zero-copy. Valida magic, versio, ordre de bytes, tipus i mides i,
+// si verify, el checksum (una passada per les dades). Llanca
+// std::runtime_error si alguna cosa no quadra. El span es valid mentre el
+// lector existeixi.
+template <typename R>
+class TransformStreamReader
+{
+public:
+    explicit TransformStreamReader(const std::string& path, bool verify = true);
+
+    std::span<const R> Records() const { return m_records; }
+    std::size_t Size() const { return m_records.size(); }
+    bool VerifyChecksum() const;
+
+private:
+    MappedFile m_file;
+    std::span<const R> m_records;
+    std::uint64_t m_checksum = 0;
+};
+
+#define LAB3_STREAM_EXTERN(R)                       \
+    extern template class TransformStreamWriter<R>; \
+    extern template class TransformStreamReader<R>;
+LAB3_STREAM_EXTERN(Matrix4x4T<float>)
+LAB3_STREAM_EXTERN(Matrix4x4T<double>)
+LAB3_STREAM_EXTERN(QuatT<float>)
+LAB3_STREAM_EXTERN(QuatT<double>)
+LAB3_STREAM_EXTERN(Vec3T<float>)
+LAB3_STREAM_EXTERN(Vec3T<double>)
+LAB3_STREAM_EXTERN(TRSRecordT<float>)
+LAB3_STREAM_EXTERN(TRSRecordT<double>)
+#undef LAB3_STREAM_EXTERN
+
+using TRSRecord = TRSRecordT<double>;
+using TRSRecordf = TRSRecordT<float>;
@@ -0,0 +1,101 @@
+#include "Affine3x4.hpp"
+#include <stdexcept>
+
+template <typename T>
+Affine3x4T<T> Affine3x4T<T>::Identity()
+{
+    Affine3x4T I;
+    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1;
+    return I;
+}
+
+template <typename T>
+Affine3x4T<T> Affine3x4T<T>::Multiply(const Affine3x4T& B) const
+{
+    // [A t] * [B u] = [A*B  A*u + t]
+    Affine3x4T C;
+    for (int i = 0; i < 3; ++i) {
+        const T a0 = At(i, 0), a1 = At(i, 1), a2 = At(i, 2);
+        for (int j = 0; j < 4; ++j) {
+            C.At(i, j) = a0 * B.At(0, j) + a1 * B.At(1, j) + a2 * B.At(2, j);
+        }
+        C.At(i, 3) += At(i, 3);
+    }
+    return C;
+}
+
+template <typename T>
+Vec3T<T> Affine3x4T<T>::TransformPoint(const Vec3T<T>& p) const
+{
+    return { At(0, 0) * p.x + At(0, 1) * p.y + At(0, 2) * p.z + At(0, 3),
+             At(1, 0) * p.x + At(1, 1) * p.y + At(1, 2) * p.z + At(1, 3),
+             At(2, 0) * p.x + At(2, 1) * p.y + At(2, 2) * p.z + At(2, 3) };
+}
+
+template <typename T>
+Vec3T<T> Affine3x4T<T>::TransformVector(const Vec3T<T>& v) const
+{
+    return { At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z,
+             At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z,
+             At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z };
+}
+
+template <typename T>
+void Affine3x4T<T>::TransformPoints(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const
+{
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("Affine3x4::TransformPoints: mides d'entrada i sortida diferents");
+    }
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = TransformPoint(in[i]);
+    }
+}
+
+template <typename T>
+Affine3x4T<T> Affine3x4T<T>::FromTRS(const Vec3T<T>& t, const Matrix3x3T<T>& R, const Vec3T<T>& s)
+{
+    const T scales[3] = { s.x, s.y, s.z };
+    Affine3x4T A;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            A.At(i, j) = R.At(i, j) * scales[j];
+        }
+    }
+    A.At(0, 3) = t.x;
+    A.At(1, 3) = t.y;
+    A.At(2, 3) = t.z;
+    return A;
+}
+
+template <typename T>
+Affine3x4T<T> Affine3x4T<T>::FromTRS(const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s)
+{
+    return FromTRS(t, q.ToMatrix3x3(), s);
+}
+
+template <typename T>
+Affine3x4T<T> Affine3x4T<T>::FromMatrix4x4(const Matrix4x4T<T>& M)
+{
+    if (!M.IsAffine()) {
+        throw std::runtime_error("Affine3x4::FromMatrix4x4: la matriu no es afi");
+    }
+    Affine3x4T A;
+    for (int k = 0; k < 12; ++k) {
+        A.m[k] = M.m[k];
+    }
+    return A;
+}
+
+template <typename T>
+Matrix4x4T<T> Affine3x4T<T>::ToMatrix4x4() const
+{
+    Matrix4x4T<T> M;
+    for (int k = 0; k < 12; ++k) {
+        M.m[k] = m[k];
+    }
+    M.At(3, 3) = 1;
+    return M;
+}
+
+template struct Affine3x4T<float>;
+template struct Affine3x4T<double>;
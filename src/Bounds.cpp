@@ -0,0 +1,327 @@
+#include "Bounds.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#if LAB3_SIMD_X86
+static_assert(sizeof(AABBT<double>) == 6 * sizeof(double), "AABB ha de ser 6 doubles contigus");
+static_assert(sizeof(SphereT<double>) == 4 * sizeof(double), "Sphere ha de ser 4 doubles contigus");
+#endif
+
+template <typename T>
+AABBT<T> AABBT<T>::FromPoints(std::span<const Vec3T<T>> points)
+{
+    if (points.empty()) {
+        throw std::invalid_argument("AABB::FromPoints: cap punt");
+    }
+    AABBT B{ points[0], points[0] };
+    for (const Vec3T<T>& p : points.subspan(1)) {
+        B.min = { std::min(B.min.x, p.x), std::min(B.min.y, p.y), std::min(B.min.z, p.z) };
+        B.max = { std::max(B.max.x, p.x), std::max(B.max.y, p.y), std::max(B.max.z, p.z) };
+    }
+    return B;
+}
+
+template <typename T>
+bool AABBT<T>::Contains(const Vec3T<T>& p) const
+{
+    return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z && p.z <= max.z;
+}
+
+template <typename T>
+AABBT<T> AABBT<T>::TransformedUnchecked(const Matrix4x4T<T>& M) const
+{
+    const Vec3T<T> c = Center(), e = Extent();
+    T nc[3], ne[3];
+    for (int i = 0; i < 3; ++i) {
+        const T* r = &M.m[4 * i];
+        nc[i] = (r[0] * c.x + r[1] * c.y) + (r[2] * c.z + r[3]);
+        ne[i] = (std::abs(r[0]) * e.x + std::abs(r[1]) * e.y) + std::abs(r[2]) * e.z;
+    }
+    return { { nc[0] - ne[0], nc[1] - ne[1], nc[2] - ne[2] }, { nc[0] + ne[0], nc[1] + ne[1], nc[2] + ne[2] } };
+}
+
+template <typename T>
+AABBT<T> AABBT<T>::Transformed(const Matrix4x4T<T>& M) const
+{
+    if (!M.IsAffine()) {
+        throw std::runtime_error("AABB::Transformed: la matriu no es afi");
+    }
+    return TransformedUnchecked(M);
+}
+
+#if LAB3_SIMD_X86
+// Columnes de la part 3x4 de M (carril = fila, el carril 3 es zero)
+LAB3_TARGET_AVX2 static inline void LoadColumns_AVX2(const double* m, __m256d& c0, __m256d& c1, __m256d& c2, __m256d& c3)
+{
+    c0 = _mm256_loadu_pd(m);
+    c1 = _mm256_loadu_pd(m + 4);
+    c2 = _mm256_loadu_pd(m + 8);
+    c3 = _mm256_setzero_pd();
+    Transpose4_AVX2(c0, c1, c2, c3);
+}
+
+// Mateixes operacions i associacio que TransformedUnchecked. La caixa de
+// sortida (6 doubles) s'escriu amb una store de 4 i una de 2 per no
+// trepitjar la seguent (in i out poden coincidir).
+#define LAB3_AABB_KERNEL(b, o)                                                                                        \
+    {                                                                                                                 \
+        const __m256d mnx = _mm256_set1_pd(b.min.x), mny = _mm256_set1_pd(b.min.y), mnz = _mm256_set1_pd(b.min.z);   \
+        const __m256d mxx = _mm256_set1_pd(b.max.x), mxy = _mm256_set1_pd(b.max.y), mxz = _mm256_set1_pd(b.max.z);   \
+        const __m256d cx = _mm256_mul_pd(_mm256_add_pd(mnx, mxx), half), ex = _mm256_mul_pd(_mm256_sub_pd(mxx, mnx), half); \
+        const __m256d cy = _mm256_mul_pd(_mm256_add_pd(mny, mxy), half), ey = _mm256_mul_pd(_mm256_sub_pd(mxy, mny), half); \
+        const __m256d cz = _mm256_mul_pd(_mm256_add_pd(mnz, mxz), half), ez = _mm256_mul_pd(_mm256_sub_pd(mxz, mnz), half); \
+        const __m256d nc = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(c0, cx), _mm256_mul_pd(c1, cy)),                 \
+                                         _mm256_add_pd(_mm256_mul_pd(c2, cz), c3));                                   \
+        const __m256d ne = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a0, ex), _mm256_mul_pd(a1, ey)),                 \
+                                         _mm256_mul_pd(a2, ez));                                                      \
+        const __m256d lo = _mm256_sub_pd(nc, ne), hi = _mm256_add_pd(nc, ne);                                         \
+        const __m256d v0 = _mm256_blend_pd(lo, _mm256_permute4x64_pd(hi, 0x00), 0x8);                                \
+        const __m128d v1 = _mm256_castpd256_pd128(_mm256_permute4x64_pd(hi, 0xF9));                                  \
+        _mm256_storeu_pd(&o.min.x, v0);                                                                               \
+        _mm_storeu_pd(&o.max.y, v1);                                                                                  \
+    }
+
+LAB3_TARGET_AVX2 static void TransformAABB_AVX2(const double* m, const AABBT<double>* in, AABBT<double>* out, std::size_t n)
+{
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d c0, c1, c2, c3;
+    LoadColumns_AVX2(m, c0, c1, c2, c3);
+    const __m256d a0 = _mm256_andnot_pd(sign, c0), a1 = _mm256_andnot_pd(sign, c1), a2 = _mm256_andnot_pd(sign, c2);
+    for (std::size_t i = 0; i < n; ++i) {
+        LAB3_AABB_KERNEL(in[i], out[i])
+    }
+}
+
+LAB3_TARGET_AVX2 static void TransformAABBPerMatrix_AVX2(const Matrix4x4T<double>* M, const AABBT<double>* in,
+                                                         AABBT<double>* out, std::size_t n)
+{
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        __m256d c0, c1, c2, c3;
+        LoadColumns_AVX2(M[i].m, c0, c1, c2, c3);
+        const __m256d a0 = _mm256_andnot_pd(sign, c0), a1 = _mm256_andnot_pd(sign, c1), a2 = _mm256_andnot_pd(sign, c2);
+        LAB3_AABB_KERNEL(in[i], out[i])
+    }
+}
+#undef LAB3_AABB_KERNEL
+#endif
+
+template <typename T>
+void AABBT<T>::TransformMany(const Matrix4x4T<T>& M, std::span<const AABBT> in, std::span<AABBT> out)
+{
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("AABB::TransformMany: mides d'entrada i sortida diferents");
+    }
+    if (!M.IsAffine()) {
+        throw std::runtime_error("AABB::TransformMany: la matriu no es afi");
+    }
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            TransformAABB_AVX2(M.m, in.data(), out.data(), in.size());
+            return;
+        }
+    }
+#endif
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = in[i].TransformedUnchecked(M);
+    }
+}
+
+template <typename T>
+void AABBT<T>::TransformMany(std::span<const Matrix4x4T<T>> M, std::span<const AABBT> in, std::span<AABBT> out)
+{
+    if (in.size() != out.size() || M.size() != in.size()) {
+        throw std::invalid_argument("AABB::TransformMany: mides d'entrada i sortida diferents");
+    }
+    for (const Matrix4x4T<T>& A : M) {
+        if (!A.IsAffine()) {
+            throw std::runtime_error("AABB::TransformMany: la matriu no es afi");
+        }
+    }
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            TransformAABBPerMatrix_AVX2(M.data(), in.data(), out.data(), in.size());
+            return;
+        }
+    }
+#endif
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = in[i].TransformedUnchecked(M[i]);
+    }
+}
+
+template <typename T>
+FrustumT<T> FrustumT<T>::FromViewProjection(const Matrix4x4T<T>& VP)
+{
+    // Un punt es dins si -w <= x, y, z <= w, es a dir (fila3 +- filaK) . p >= 0
+    FrustumT F;
+    const T* r3 = &VP.m[12];
+    for (int k = 0; k < 3; ++k) {
+        const T* r = &VP.m[4 * k];
+        F.planes[2 * k]     = { { r3[0] + r[0], r3[1] + r[1], r3[2] + r[2] }, r3[3] + r[3] };
+        F.planes[2 * k + 1] = { { r3[0] - r[0], r3[1] - r[1], r3[2] - r[2] }, r3[3] - r[3] };
+    }
+    for (PlaneT<T>& P : F.planes) {
+        const T len = P.n.Norm();
+        if (len > 0) {
+            const T inv = T(1) / len;
+            P.n = { P.n.x * inv, P.n.y * inv, P.n.z * inv };
+            P.d *= inv;
+        }
+    }
+    return F;
+}
+
+// Les comparacions son !(x >= 0) perque un NaN es consideri no visible, igual
+// que al kernel SIMD
+template <typename T>
+bool FrustumT<T>::Intersects(const AABBT<T>& box) const
+{
+    // Centre-extensio: la cantonada mes positiva respecte del pla esta a
+    // distancia n.c + d + |n|.e
+    const Vec3T<T> c = box.Center(), e = box.Extent();
+    for (const PlaneT<T>& P : planes) {
+        const T r = std::abs(P.n.x) * e.x + std::abs(P.n.y) * e.y + std::abs(P.n.z) * e.z;
+        if (!(P.Distance(c) + r >= 0)) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool FrustumT<T>::Intersects(const SphereT<T>& sphere) const
+{
+    for (const PlaneT<T>& P : planes) {
+        if (!(P.Distance(sphere.center) + sphere.radius >= 0)) return false;
+    }
+    return true;
+}
+
+static void PrepareMask(std::size_t n, std::span<std::uint64_t> visible)
+{
+    const std::size_t words = (n + 63) / 64;
+    if (visible.size() < words) {
+        throw std::invalid_argument("Frustum::Cull: mascara massa petita");
+    }
+    std::fill(visible.begin(), visible.begin() + words, std::uint64_t(0));
+}
+
+#if LAB3_SIMD_X86
+// Els sis plans es proven sobre quatre volums alhora (un per carril). Retorna
+// el primer index no processat; els bits de cada grup de 4 cauen dins la
+// mateixa paraula perque i es multiple de 4.
+LAB3_TARGET_AVX2 static std::size_t CullAABB_AVX2(const PlaneT<double>* planes, const AABBT<double>* boxes,
+                                                  std::uint64_t* visible, std::size_t n, std::size_t& count)
+{
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d zero = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // Caixa k = 6 doubles a p + 6k: (mnx mny mnz mxx) a +0 i (mnz mxx mxy mxz) a +2
+        const double* p = &boxes[i].min.x;
+        __m256d a0 = _mm256_loadu_pd(p), a1 = _mm256_loadu_pd(p + 6), a2 = _mm256_loadu_pd(p + 12), a3 = _mm256_loadu_pd(p + 18);
+        __m256d b0 = _mm256_loadu_pd(p + 2), b1 = _mm256_loadu_pd(p + 8), b2 = _mm256_loadu_pd(p + 14), b3 = _mm256_loadu_pd(p + 20);
+        Transpose4_AVX2(a0, a1, a2, a3);   // a0 = min.x, a1 = min.y, a2 = min.z, a3 = max.x
+        Transpose4_AVX2(b0, b1, b2, b3);   // b2 = max.y, b3 = max.z
+        const __m256d cx = _mm256_mul_pd(_mm256_add_pd(a0, a3), half), ex = _mm256_mul_pd(_mm256_sub_pd(a3, a0), half);
+        const __m256d cy = _mm256_mul_pd(_mm256_add_pd(a1, b2), half), ey = _mm256_mul_pd(_mm256_sub_pd(b2, a1), half);
+        const __m256d cz = _mm256_mul_pd(_mm256_add_pd(a2, b3), half), ez = _mm256_mul_pd(_mm256_sub_pd(b3, a2), half);
+
+        __m256d in = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (int k = 0; k < 6; ++k) {
+            const PlaneT<double>& P = planes[k];
+            const __m256d d = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(P.n.x), cx), _mm256_mul_pd(_mm256_set1_pd(P.n.y), cy)),
+                _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(P.n.z), cz), _mm256_set1_pd(P.d)));
+            const __m256d r = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(std::abs(P.n.x)), ex), _mm256_mul_pd(_mm256_set1_pd(std::abs(P.n.y)), ey)),
+                _mm256_mul_pd(_mm256_set1_pd(std::abs(P.n.z)), ez));
+            in = _mm256_and_pd(in, _mm256_cmp_pd(_mm256_add_pd(d, r), zero, _CMP_GE_OQ));
+        }
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(in));
+        visible[i / 64] |= std::uint64_t(mask) << (i % 64);
+        count += static_cast<std::size_t>(std::popcount(mask));
+    }
+    return i;
+}
+
+LAB3_TARGET_AVX2 static std::size_t CullSphere_AVX2(const PlaneT<double>* planes, const SphereT<double>* spheres,
+                                                    std::uint64_t* visible, std::size_t n, std::size_t& count)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const double* p = &spheres[i].center.x;
+        __m256d cx = _mm256_loadu_pd(p), cy = _mm256_loadu_pd(p + 4), cz = _mm256_loadu_pd(p + 8), r = _mm256_loadu_pd(p + 12);
+        Transpose4_AVX2(cx, cy, cz, r);
+
+        __m256d in = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (int k = 0; k < 6; ++k) {
+            const PlaneT<double>& P = planes[k];
+            const __m256d d = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(P.n.x), cx), _mm256_mul_pd(_mm256_set1_pd(P.n.y), cy)),
+                _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(P.n.z), cz), _mm256_set1_pd(P.d)));
+            in = _mm256_and_pd(in, _mm256_cmp_pd(_mm256_add_pd(d, r), zero, _CMP_GE_OQ));
+        }
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(in));
+        visible[i / 64] |= std::uint64_t(mask) << (i % 64);
+        count += static_cast<std::size_t>(std::popcount(mask));
+    }
+    return i;
+}
+#endif
+
+template <typename T>
+std::size_t FrustumT<T>::Cull(std::span<const AABBT<T>> boxes, std::span<std::uint64_t> visible) const
+{
+    const std::size_t n = boxes.size();
+    PrepareMask(n, visible);
+    std::size_t i = 0, count = 0;
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            i = CullAABB_AVX2(planes, boxes.data(), visible.data(), n, count);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (Intersects(boxes[i])) {
+            visible[i / 64] |= std::uint64_t(1) << (i % 64);
+            ++count;
+        }
+    }
+    return count;
+}
+
+template <typename T>
+std::size_t FrustumT<T>::Cull(std::span<const SphereT<T>> spheres, std::span<std::uint64_t> visible) const
+{
+    const std::size_t n = spheres.size();
+    PrepareMask(n, visible);
+    std::size_t i = 0, count = 0;
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            i = CullSphere_AVX2(planes, spheres.data(), visible.data(), n, count);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (Intersects(spheres[i])) {
+            visible[i / 64] |= std::uint64_t(1) << (i % 64);
+            ++count;
+        }
+    }
+    return count;
+}
+
+template struct AABBT<float>;
+template struct AABBT<double>;
+template struct FrustumT<float>;
+template struct FrustumT<double>;
@@ -0,0 +1,161 @@
+#include "DualQuat.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+template <typename T>
+DualQuatT<T> DualQuatT<T>::FromRotationTranslation(const QuatT<T>& q, const Vec3T<T>& t)
+{
+    // dual = 0.5 * (0, t) * q
+    DualQuatT D;
+    D.real = q;
+    D.dual.s = T(-0.5) * (t.x * q.x + t.y * q.y + t.z * q.z);
+    D.dual.x = T(0.5) * (q.s * t.x + t.y * q.z - t.z * q.y);
+    D.dual.y = T(0.5) * (q.s * t.y + t.z * q.x - t.x * q.z);
+    D.dual.z = T(0.5) * (q.s * t.z + t.x * q.y - t.y * q.x);
+    return D;
+}
+
+template <typename T>
+DualQuatT<T> DualQuatT<T>::FromMatrix4x4(const Matrix4x4T<T>& M)
+{
+    // GetRotationQuat llanca si no es afi o la part 3x3 no es rotacio+escala
+    return FromRotationTranslation(M.GetRotationQuat(), M.GetTranslation());
+}
+
+template <typename T>
+Matrix4x4T<T> DualQuatT<T>::ToMatrix4x4() const
+{
+    return Matrix4x4T<T>::FromTRS(GetTranslation(), real, Vec3T<T>{ 1, 1, 1 });
+}
+
+template <typename T>
+Vec3T<T> DualQuatT<T>::GetTranslation() const
+{
+    // t = 2 * vec(dual * conj(real)) = 2 (w b - dw a + a x b)
+    const QuatT<T>& r = real;
+    const QuatT<T>& d = dual;
+    return { T(2) * (r.s * d.x - d.s * r.x + r.y * d.z - r.z * d.y),
+             T(2) * (r.s * d.y - d.s * r.y + r.z * d.x - r.x * d.z),
+             T(2) * (r.s * d.z - d.s * r.z + r.x * d.y - r.y * d.x) };
+}
+
+template <typename T>
+DualQuatT<T> DualQuatT<T>::Multiply(const DualQuatT& b) const
+{
+    DualQuatT C;
+    C.real = real.Multiply(b.real);
+    const QuatT<T> d0 = real.Multiply(b.dual);
+    const QuatT<T> d1 = dual.Multiply(b.real);
+    C.dual = { d0.s + d1.s, d0.x + d1.x, d0.y + d1.y, d0.z + d1.z };
+    return C;
+}
+
+template <typename T>
+DualQuatT<T> DualQuatT<T>::Inverse() const
+{
+    DualQuatT I;
+    I.real = { real.s, -real.x, -real.y, -real.z };
+    I.dual = { dual.s, -dual.x, -dual.y, -dual.z };
+    return I;
+}
+
+template <typename T>
+DualQuatT<T> DualQuatT<T>::Normalized() const
+{
+    const T n = std::sqrt(real.s * real.s + real.x * real.x + real.y * real.y + real.z * real.z);
+    if (n == 0) throw std::invalid_argument("DualQuat::Normalized: zero norm");
+    const T inv = T(1) / n;
+    DualQuatT D;
+    D.real = { real.s * inv, real.x * inv, real.y * inv, real.z * inv };
+    D.dual = { dual.s * inv, dual.x * inv, dual.y * inv, dual.z * inv };
+    return D;
+}
+
+template <typename T>
+Vec3T<T> DualQuatT<T>::TransformPoint(const Vec3T<T>& p) const
+{
+    const Vec3T<T> r = real.Rotate(p);
+    const Vec3T<T> t = GetTranslation();
+    return { r.x + t.x, r.y + t.y, r.z + t.z };
+}
+
+template <typename T>
+Vec3T<T> DualQuatT<T>::TransformVector(const Vec3T<T>& v) const
+{
+    return real.Rotate(v);
+}
+
+template <typename T>
+void DualQuatT<T>::SkinMany(std::span<const DualQuatT> palette,
+                            std::span<const Vec3T<T>> positions,
+                            std::span<const std::uint16_t> indices,
+                            std::span<const T> weights,
+                            std::span<Vec3T<T>> outPositions,
+                            std::span<const Vec3T<T>> normals,
+                            std::span<Vec3T<T>> outNormals)
+{
+    const std::size_t n = positions.size();
+    if (indices.size() != 4 * n || weights.size() != 4 * n || outPositions.size() != n) {
+        throw std::invalid_argument("DualQuat::SkinMany: mides de les entrades diferents");
+    }
+    const bool doNormals = !normals.empty() || !outNormals.empty();
+    if (doNormals && (normals.size() != n || outNormals.size() != n)) {
+        throw std::invalid_argument("DualQuat::SkinMany: mides de les normals diferents");
+    }
+    // Validacio un sol cop: el bucle no comprova indexs
+    if (!indices.empty() && *std::max_element(indices.begin(), indices.end()) >= palette.size()) {
+        throw std::invalid_argument("DualQuat::SkinMany: index d'os fora de la paleta");
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint16_t* idx = &indices[4 * i];
+        const T* w = &weights[4 * i];
+        const DualQuatT& b0 = palette[idx[0]];
+
+        // Barreja alineada amb el primer os: el signe evita el cami llarg
+        T rs = 0, rx = 0, ry = 0, rz = 0, ds = 0, dx = 0, dy = 0, dz = 0;
+        for (int k = 0; k < 4; ++k) {
+            const DualQuatT& b = palette[idx[k]];
+            const T dot = b0.real.s * b.real.s + b0.real.x * b.real.x + b0.real.y * b.real.y + b0.real.z * b.real.z;
+            const T wk = (dot < 0) ? -w[k] : w[k];
+            rs += wk * b.real.s; rx += wk * b.real.x; ry += wk * b.real.y; rz += wk * b.real.z;
+            ds += wk * b.dual.s; dx += wk * b.dual.x; dy += wk * b.dual.y; dz += wk * b.dual.z;
+        }
+        // Tots els pesos 0 (vertex sense pell o de farciment): es copia tal qual
+        const T n2 = rs * rs + rx * rx + ry * ry + rz * rz;
+        if (n2 <= Tol<T>() * Tol<T>()) {
+            outPositions[i] = positions[i];
+            if (doNormals) {
+                outNormals[i] = normals[i];
+            }
+            continue;
+        }
+        const T inv = T(1) / std::sqrt(n2);
+        rs *= inv; rx *= inv; ry *= inv; rz *= inv;
+        ds *= inv; dx *= inv; dy *= inv; dz *= inv;
+
+        // t = 2 (w b - dw a + a x b)
+        const T tx = T(2) * (rs * dx - ds * rx + ry * dz - rz * dy);
+        const T ty = T(2) * (rs * dy - ds * ry + rz * dx - rx * dz);
+        const T tz = T(2) * (rs * dz - ds * rz + rx * dy - ry * dx);
+
+        // Rotacio: v' = v + s*c + a x c, amb c = 2 (a x v)
+        auto rotate = [&](const Vec3T<T>& v) -> Vec3T<T> {
+            const T cx = T(2) * (ry * v.z - rz * v.y);
+            const T cy = T(2) * (rz * v.x - rx * v.z);
+            const T cz = T(2) * (rx * v.y - ry * v.x);
+            return { v.x + rs * cx + (ry * cz - rz * cy),
+                     v.y + rs * cy + (rz * cx - rx * cz),
+                     v.z + rs * cz + (rx * cy - ry * cx) };
+        };
+        const Vec3T<T> p = rotate(positions[i]);
+        outPositions[i] = { p.x + tx, p.y + ty, p.z + tz };
+        if (doNormals) {
+            outNormals[i] = rotate(normals[i]);
+        }
+    }
+}
+
+template struct DualQuatT<float>;
+template struct DualQuatT<double>;
@@ -0,0 +1,180 @@
+#include "FrameArena.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+// --------------------------------------------------------------------------
+// Arena
+// --------------------------------------------------------------------------
+
+FrameArena::FrameArena(std::size_t capacity)
+{
+    AddBlock(std::max(capacity, Alignment));
+}
+
+FrameArena::~FrameArena()
+{
+    FreeBlocks();
+}
+
+void FrameArena::AddBlock(std::size_t size)
+{
+    m_blocks.reserve(m_blocks.size() + 1);
+    std::byte* p = static_cast<std::byte*>(::operator new(size, std::align_val_t(Alignment)));
+    m_blocks.push_back({ p, size });
+}
+
+void FrameArena::FreeBlocks()
+{
+    for (const Block& b : m_blocks) {
+        ::operator delete(b.data, std::align_val_t(Alignment));
+    }
+    m_blocks.clear();
+}
+
+void* FrameArena::Allocate(std::size_t bytes, std::size_t align)
+{
+    if (align == 0 || (align & (align - 1)) != 0) {
+        throw std::invalid_argument("FrameArena::Allocate: l'alineacio ha de ser potencia de 2");
+    }
+    const Block& b = m_blocks.back();
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(b.data);
+    const std::uintptr_t start = (base + m_offset + (align - 1)) & ~std::uintptr_t(align - 1);
+    const std::size_t offset = static_cast<std::size_t>(start - base);
+    if (offset <= b.size && bytes <= b.size - offset) {
+        m_offset = offset + bytes;
+        return b.data + offset;
+    }
+    // No hi cap: bloc nou com a minim el doble de l'anterior
+    if (bytes > static_cast<std::size_t>(-1) / 2 - align) {
+        throw std::bad_alloc();
+    }
+    AddBlock(std::max(2 * b.size, bytes + align));
+    m_usedBefore += m_offset;
+    m_offset = 0;
+    return Allocate(bytes, align);
+}
+
+void FrameArena::Reset()
+{
+    if (m_blocks.size() > 1) {
+        // Un sol bloc amb tota la capacitat: el proxim frame hi cap sense malloc.
+        // Es reserva abans d'alliberar: si falla, l'arena queda com estava.
+        // Despres de clear() el vector conserva capacitat i push_back no llanca.
+        const std::size_t total = Capacity();
+        std::byte* p = static_cast<std::byte*>(::operator new(total, std::align_val_t(Alignment)));
+        FreeBlocks();
+        m_blocks.push_back({ p, total });
+    }
+    m_offset = 0;
+    m_usedBefore = 0;
+}
+
+std::size_t FrameArena::Capacity() const
+{
+    std::size_t total = 0;
+    for (const Block& b : m_blocks) total += b.size;
+    return total;
+}
+
+// --------------------------------------------------------------------------
+// Contenidors SoA
+// --------------------------------------------------------------------------
+
+static void CheckSoASize(std::size_t n, std::size_t n_aos)
+{
+    if (n != n_aos) {
+        throw std::invalid_argument("SoA: mides d'entrada i sortida diferents");
+    }
+}
+
+template <typename T>
+Vec3SoAT<T> Vec3SoAT<T>::Allocate(FrameArena& arena, std::size_t n)
+{
+    Vec3SoAT V;
+    V.x = arena.AllocateUninitialized<T>(n);
+    V.y = arena.AllocateUninitialized<T>(n);
+    V.z = arena.AllocateUninitialized<T>(n);
+    return V;
+}
+
+template <typename T>
+void Vec3SoAT<T>::Load(std::span<const Vec3T<T>> in)
+{
+    CheckSoASize(Size(), in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) Set(i, in[i]);
+}
+
+template <typename T>
+void Vec3SoAT<T>::Store(std::span<Vec3T<T>> out) const
+{
+    CheckSoASize(Size(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) out[i] = Get(i);
+}
+
+template <typename T>
+QuatSoAT<T> QuatSoAT<T>::Allocate(FrameArena& arena, std::size_t n)
+{
+    QuatSoAT Q;
+    Q.s = arena.AllocateUninitialized<T>(n);
+    Q.x = arena.AllocateUninitialized<T>(n);
+    Q.y = arena.AllocateUninitialized<T>(n);
+    Q.z = arena.AllocateUninitialized<T>(n);
+    return Q;
+}
+
+template <typename T>
+void QuatSoAT<T>::Load(std::span<const QuatT<T>> in)
+{
+    CheckSoASize(Size(), in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) Set(i, in[i]);
+}
+
+template <typename T>
+void QuatSoAT<T>::Store(std::span<QuatT<T>> out) const
+{
+    CheckSoASize(Size(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) out[i] = Get(i);
+}
+
+template <typename T>
+Matrix4x4SoAT<T> Matrix4x4SoAT<T>::Allocate(FrameArena& arena, std::size_t n)
+{
+    Matrix4x4SoAT M;
+    for (std::span<T>& e : M.m) e = arena.AllocateUninitialized<T>(n);
+    return M;
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4SoAT<T>::Get(std::size_t i) const
+{
+    Matrix4x4T<T> M;
+    for (int k = 0; k < 16; ++k) M.m[k] = m[k][i];
+    return M;
+}
+
+template <typename T>
+void Matrix4x4SoAT<T>::Set(std::size_t i, const Matrix4x4T<T>& M)
+{
+    for (int k = 0; k < 16; ++k) m[k][i] = M.m[k];
+}
+
+template <typename T>
+void Matrix4x4SoAT<T>::Load(std::span<const Matrix4x4T<T>> in)
+{
+    CheckSoASize(Size(), in.size());
+    for (std::size_t i = 0; i < in.size(); ++i) Set(i, in[i]);
+}
+
+template <typename T>
+void Matrix4x4SoAT<T>::Store(std::span<Matrix4x4T<T>> out) const
+{
+    CheckSoASize(Size(), out.size());
+    for (std::size_t i = 0; i < out.size(); ++i) out[i] = Get(i);
+}
+
+template struct Vec3SoAT<float>;
+template struct Vec3SoAT<double>;
+template struct QuatSoAT<float>;
+template struct QuatSoAT<double>;
+template struct Matrix4x4SoAT<float>;
+template struct Matrix4x4SoAT<double>;
@@ -1,100 +1,37 @@
 #include "Matrix3x3.hpp"
 #include <stdexcept>
 
-#define TOL 1e-6
 #define PI 3.14159265358979323846
 
 // ------------------ Vec3 -------------------------
 
-double Vec3::Dot(const Vec3& a, const Vec3& b)
-{
-    return a.x * b.x + a.y * b.y + a.z * b.z;
-}
-
-Vec3 Vec3::Cross(const Vec3& a, const Vec3& b)
-{
-    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
-}
-
-double Vec3::Norm() const
+template <typename T>
+T Vec3T<T>::Norm() const
 {
     return std::sqrt(Dot(*this, *this));
 }
 
-Vec3 Vec3::Normalize() const
+template <typename T>
+Vec3T<T> Vec3T<T>::Normalize() const
 {
-    double n = Norm();
+    T n = Norm();
     if (n == 0) throw std::invalid_argument("normalize: zero vector");
     return { x / n, y / n, z / n };
 }
 
 // ------------------ Matrix3x3 ---------------------
 
-Matrix3x3 Matrix3x3::Identity()
-{
-    Matrix3x3 I;
-    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1;
-    return I;
-}
-
-Vec3 Matrix3x3::Multiply(const Vec3& x) const
-{
-    // y = A * x
-    Vec3 y;
-    y.x = At(0, 0) * x.x + At(0, 1) * x.y + At(0, 2) * x.z;
-    y.y = At(1, 0) * x.x + At(1, 1) * x.y + At(1, 2) * x.z;
-    y.z = At(2, 0) * x.x + At(2, 1) * x.y + At(2, 2) * x.z;
-    return y;
-}
-
-Matrix3x3 Matrix3x3::Multiply(const Matrix3x3& B) const
-{
-    Matrix3x3 C{};
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            double s = 0.0;
-            for (int k = 0; k < 3; ++k) {
-                s += At(i, k) * B.At(k, j);
-            }
-            C.At(i, j) = s;
-        }
-    }
-    return C;
-}
-
-double Matrix3x3::Det() const
-{
-    const double a = At(0, 0), b = At(0, 1), c = At(0, 2);
-    const double d = At(1, 0), e = At(1, 1), f = At(1, 2);
-    const double g = At(2, 0), h = At(2, 1), i = At(2, 2);
-    return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
-}
-
-Matrix3x3 Matrix3x3::Transposed() const
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::RotationAxisAngle(const Vec3T<T>& u_in, T phi)
 {
-    Matrix3x3 R{};
-    for (int i = 0; i < 3; ++i)
-        for (int j = 0; j < 3; ++j)
-            R.At(i, j) = At(j, i);
-    return R;
-}
+    Vec3T<T> u = u_in.Normalize();
+    const T c = std::cos(phi);
+    const T s = std::sin(phi);
+    const T t = T(1) - c;
 
-double Matrix3x3::Trace() const
-{
-    return At(0, 0) + At(1, 1) + At(2, 2);
-}
+    const T ux = u.x, uy = u.y, uz = u.z;
 
-
-Matrix3x3 Matrix3x3::RotationAxisAngle(const Vec3& u_in, double phi)
-{
-    Vec3 u = u_in.Normalize();
-    const double c = std::cos(phi);
-    const double s = std::sin(phi);
-    const double t = 1.0 - c;
-
-    const double ux = u.x, uy = u.y, uz = u.z;
-
-    Matrix3x3 R{};
+    Matrix3x3T R{};
     R.At(0, 0) = c + t * ux * ux;
     R.At(0, 1) = t * ux * uy - s * uz;
     R.At(0, 2) = t * ux * uz + s * uy;
@@ -109,75 +46,82 @@ Matrix3x3 Matrix3x3::RotationAxisAngle(const Vec3& u_in, double phi)
     return R;
 }
 
-bool Matrix3x3::IsRotation() const
+template <typename T>
+bool Matrix3x3T<T>::IsRotation() const
 {
-    Matrix3x3 Rt = this->Transposed();
-    Matrix3x3 RtR = Rt.Multiply(*this);
-    Matrix3x3 I = Identity();
+    // R^T R = I comparat element a element: (R^T R)(i, j) es el producte
+    // escalar de les columnes i i j. Es calcula directament, sense construir
+    // Transposed(), el producte complet ni Identity().
+    const T a = At(0, 0), b = At(0, 1), c = At(0, 2);
+    const T d = At(1, 0), e = At(1, 1), f = At(1, 2);
+    const T g = At(2, 0), h = At(2, 1), i = At(2, 2);
 
-    for (int i = 0; i < 3; ++i)
-    {
-        for (int j = 0; j < 3; ++j)
-        {
-            if (std::fabs(RtR.At(i, j) - I.At(i, j)) > TOL) return false;
-        }
-    }
+    const T tol = Tol<T>();
+    if (std::fabs(a * a + d * d + g * g - T(1)) > tol) return false;
+    if (std::fabs(b * b + e * e + h * h - T(1)) > tol) return false;
+    if (std::fabs(c * c + f * f + i * i - T(1)) > tol) return false;
+    if (std::fabs(a * b + d * e + g * h) > tol) return false;
+    if (std::fabs(a * c + d * f + g * i) > tol) return false;
+    if (std::fabs(b * c + e * f + h * i) > tol) return false;
 
-    if (std::fabs(Det() - 1.0) > TOL) return false;
+    if (std::fabs(Det() - T(1)) > tol) return false;
 
     return true;
 }
 
-Vec3 Matrix3x3::Rotate(const Vec3& v) const
+template <typename T>
+Vec3T<T> Matrix3x3T<T>::Rotate(const Vec3T<T>& v) const
 {
     return Multiply(v);
 }
 
-void Matrix3x3::ToAxisAngle(Vec3& axis, double& angle) const
+template <typename T>
+void Matrix3x3T<T>::ToAxisAngle(Vec3T<T>& axis, T& angle) const
 {
     if (!IsRotation()) throw std::invalid_argument("ToAxisAngle: matrix is not a rotation");
 
-    double tr = Trace();
-    double cos_a = (tr - 1.0) * 0.5;
+    T tr = Trace();
+    T cos_a = (tr - T(1)) * T(0.5);
     angle = std::acos(cos_a);
 
-    if (std::fabs(angle) < TOL)
+    if (std::fabs(angle) < Tol<T>())
     {
         axis = { 1,0,0 };
         return;
     }
 
-    if (std::fabs(PI - angle) < TOL)
+    if (std::fabs(T(PI) - angle) < Tol<T>())
     {
-        double xx = (At(0, 0) + 1.0) * 0.5;
-        double yy = (At(1, 1) + 1.0) * 0.5;
-        double zz = (At(2, 2) + 1.0) * 0.5;
-        double x = std::sqrt(xx);
-        double y = std::sqrt(yy);
-        double z = std::sqrt(zz);
+        T xx = (At(0, 0) + T(1)) * T(0.5);
+        T yy = (At(1, 1) + T(1)) * T(0.5);
+        T zz = (At(2, 2) + T(1)) * T(0.5);
+        T x = std::sqrt(xx);
+        T y = std::sqrt(yy);
+        T z = std::sqrt(zz);
 
-        if (At(0, 1) + At(1, 0) < 0.0) y = -y;
-        if (At(0, 2) + At(2, 0) < 0.0) z = -z;
+        if (At(0, 1) + At(1, 0) < T(0)) y = -y;
+        if (At(0, 2) + At(2, 0) < T(0)) z = -z;
 
-        axis = Vec3{ x, y, z }.Normalize();
+        axis = Vec3T<T>{ x, y, z }.Normalize();
 
         return;
     }
 
-    double denom = 2.0 * std::sin(angle);
+    T denom = T(2) * std::sin(angle);
     axis.x = (At(2, 1) - At(1, 2)) / denom;
     axis.y = (At(0, 2) - At(2, 0)) / denom;
     axis.z = (At(1, 0) - At(0, 1)) / denom;
     axis = axis.Normalize();
 }
 
-Matrix3x3 Matrix3x3::FromEulerZYX(double yaw, double pitch, double roll)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::FromEulerZYX(T yaw, T pitch, T roll)
 {
-    const double cy = std::cos(yaw), sy = std::sin(yaw);
-    const double cp = std::cos(pitch), sp = std::sin(pitch);
-    const double cr = std::cos(roll), sr = std::sin(roll);
+    const T cy = std::cos(yaw), sy = std::sin(yaw);
+    const T cp = std::cos(pitch), sp = std::sin(pitch);
+    const T cr = std::cos(roll), sr = std::sin(roll);
 
-    Matrix3x3 R{};
+    Matrix3x3T R{};
     R.At(0, 0) = cy * cp;
     R.At(0, 1) = cy * sp * sr - sy * cr;
     R.At(0, 2) = cy * sp * cr + sy * sr;
@@ -192,11 +136,12 @@ Matrix3x3 Matrix3x3::FromEulerZYX(double yaw, double pitch, double roll)
     return R;
 }
 
-void Matrix3x3::ToEulerZYX(double& yaw, double& pitch, double& roll) const
+template <typename T>
+void Matrix3x3T<T>::ToEulerZYX(T& yaw, T& pitch, T& roll) const
 {
-    double r20 = At(2, 0);
+    T r20 = At(2, 0);
 
-    if (std::fabs(r20) < 1.0 - TOL)
+    if (std::fabs(r20) < T(1) - Tol<T>())
     {
         pitch = std::asin(-r20);
         yaw = std::atan2(At(1, 0), At(0, 0));
@@ -204,44 +149,51 @@ void Matrix3x3::ToEulerZYX(double& yaw, double& pitch, double& roll) const
     }
     else
     {
-        pitch = (r20 < 0.0) ? +PI / 2 : -PI / 2;
+        pitch = (r20 < T(0)) ? T(PI / 2) : T(-PI / 2);
         yaw = std::atan2(-At(0, 1), At(1, 1));
-        roll = 0.0;
+        roll = 0;
     }
 }
 
-Matrix3x3 Matrix3x3::RotateFromTo(const Vec3& u, const Vec3& v)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::RotateFromTo(const Vec3T<T>& u, const Vec3T<T>& v)
 {
-    Vec3 a{ u.Normalize()};
-    Vec3 b{ v.Normalize()};
+    Vec3T<T> a{ u.Normalize()};
+    Vec3T<T> b{ v.Normalize()};
 
-    double dot = Vec3::Dot(a, b);
+    T dot = Vec3T<T>::Dot(a, b);
 
-    if (std::fabs(dot - 1.0) < TOL) 
+    if (std::fabs(dot - T(1)) < Tol<T>()) 
     {
         return Identity();
     }
 
-    if (std::fabs(dot + 1.0) < TOL) 
+    if (std::fabs(dot + T(1)) < Tol<T>()) 
     {
-        Vec3 arbitrary = (std::fabs(a.x) < 0.9) ? Vec3{ 1,0,0 } : Vec3{ 0,1,0 };
-        Vec3 axis = Vec3::Cross(a, arbitrary).Normalize();
-        return RotationAxisAngle(axis, PI);
+        Vec3T<T> arbitrary = (std::fabs(a.x) < T(0.9)) ? Vec3T<T>{ 1,0,0 } : Vec3T<T>{ 0,1,0 };
+        Vec3T<T> axis = Vec3T<T>::Cross(a, arbitrary).Normalize();
+        return RotationAxisAngle(axis, T(PI));
     }
 
-    Vec3 axis = Vec3::Cross(a, b).Normalize();
-    double angle = std::acos(dot);
+    Vec3T<T> axis = Vec3T<T>::Cross(a, b).Normalize();
+    T angle = std::acos(dot);
     return RotationAxisAngle(axis, angle);
 }
 
-Matrix3x3 Matrix3x3::RotateToTarget(const Matrix3x3& initialRot, const Matrix3x3& finalRot)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::RotateToTarget(const Matrix3x3T& initialRot, const Matrix3x3T& finalRot)
 {
     if (!initialRot.IsRotation())
         throw std::invalid_argument("RotateToTarget: initialRot is not a rotation");
     if (!finalRot.IsRotation())
         throw std::invalid_argument("RotateToTarget: finalRot is not a rotation");
 
-    Matrix3x3 RiT = initialRot.Transposed();
-    Matrix3x3 Rdelta = finalRot.Multiply(RiT);
+    Matrix3x3T RiT = initialRot.Transposed();
+    Matrix3x3T Rdelta = finalRot.Multiply(RiT);
     return Rdelta;
 }
+
+template struct Vec3T<float>;
+template struct Vec3T<double>;
+template struct Matrix3x3T<float>;
+template struct Matrix3x3T<double>;
@@ -1,57 +1,242 @@
 #include "Matrix4x4.hpp"
+#include "Simd.hpp"
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
-#define TOL 1e-6
+#define PI 3.14159265358979323846
 
-Matrix4x4 Matrix4x4::Identity()
-{
-    Matrix4x4 I;
-    I.At(0, 0) = 1; I.At(1, 1) = 1; I.At(2, 2) = 1; I.At(3, 3) = 1;
-    return I;
-}
+// --------------------------------------------------------------------------
+// Kernels del producte. L'escalar es la referencia; els SIMD fan les sumes en
+// el mateix ordre (excepte FMA, que nomes arrodoneix un cop per terme).
+// --------------------------------------------------------------------------
 
-Matrix4x4 Matrix4x4::Multiply(const Matrix4x4& B) const
+template <typename T>
+static void Mul4x4_Scalar(const T* a, const T* b, T* c)
 {
-    Matrix4x4 C{};
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 4; ++j) {
-            double sum = 0.0;
+            T sum = 0;
             for (int k = 0; k < 4; ++k) {
-                sum += At(i, k) * B.At(k, j);
+                sum += a[i * 4 + k] * b[k * 4 + j];
             }
-            C.At(i, j) = sum;
+            c[i * 4 + j] = sum;
+        }
+    }
+}
+
+template <typename T>
+static void Mul4x4Vec_Scalar(const T* a, const T* v, T* r)
+{
+    for (int i = 0; i < 4; ++i) {
+        r[i] = a[i * 4 + 0] * v[0] + a[i * 4 + 1] * v[1] + a[i * 4 + 2] * v[2] + a[i * 4 + 3] * v[3];
+    }
+}
+
+#if LAB3_SIMD_X86
+
+// Fila i de C = sum_k A(i,k) * fila k de B
+LAB3_TARGET_SSE2 static void Mul4x4_SSE2(const double* a, const double* b, double* c)
+{
+    for (int i = 0; i < 4; ++i) {
+        __m128d a0 = _mm_set1_pd(a[i * 4 + 0]);
+        __m128d lo = _mm_mul_pd(a0, _mm_loadu_pd(b + 0));
+        __m128d hi = _mm_mul_pd(a0, _mm_loadu_pd(b + 2));
+        for (int k = 1; k < 4; ++k) {
+            __m128d ak = _mm_set1_pd(a[i * 4 + k]);
+            lo = _mm_add_pd(lo, _mm_mul_pd(ak, _mm_loadu_pd(b + k * 4 + 0)));
+            hi = _mm_add_pd(hi, _mm_mul_pd(ak, _mm_loadu_pd(b + k * 4 + 2)));
         }
+        _mm_storeu_pd(c + i * 4 + 0, lo);
+        _mm_storeu_pd(c + i * 4 + 2, hi);
+    }
+}
+
+// r = sum_j v_j * columna j de A (les columnes surten de desempaquetar parelles de files)
+LAB3_TARGET_SSE2 static void Mul4x4Vec_SSE2(const double* a, const double* v, double* r)
+{
+    for (int h = 0; h < 2; ++h) {
+        const double* r0 = a + (h * 2 + 0) * 4;
+        const double* r1 = a + (h * 2 + 1) * 4;
+        __m128d r0lo = _mm_loadu_pd(r0), r0hi = _mm_loadu_pd(r0 + 2);
+        __m128d r1lo = _mm_loadu_pd(r1), r1hi = _mm_loadu_pd(r1 + 2);
+
+        __m128d acc = _mm_mul_pd(_mm_unpacklo_pd(r0lo, r1lo), _mm_set1_pd(v[0]));
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_unpackhi_pd(r0lo, r1lo), _mm_set1_pd(v[1])));
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_unpacklo_pd(r0hi, r1hi), _mm_set1_pd(v[2])));
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_unpackhi_pd(r0hi, r1hi), _mm_set1_pd(v[3])));
+        _mm_storeu_pd(r + h * 2, acc);
+    }
+}
+
+LAB3_TARGET_AVX2 static void Mul4x4_AVX2(const double* a, const double* b, double* c)
+{
+    const __m256d b0 = _mm256_loadu_pd(b + 0);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    const __m256d b2 = _mm256_loadu_pd(b + 8);
+    const __m256d b3 = _mm256_loadu_pd(b + 12);
+    for (int i = 0; i < 4; ++i) {
+        __m256d row = _mm256_mul_pd(_mm256_broadcast_sd(a + i * 4 + 0), b0);
+        row = _mm256_add_pd(row, _mm256_mul_pd(_mm256_broadcast_sd(a + i * 4 + 1), b1));
+        row = _mm256_add_pd(row, _mm256_mul_pd(_mm256_broadcast_sd(a + i * 4 + 2), b2));
+        row = _mm256_add_pd(row, _mm256_mul_pd(_mm256_broadcast_sd(a + i * 4 + 3), b3));
+        _mm256_storeu_pd(c + i * 4, row);
+    }
+}
+
+// Transposa A a registres: c[j] = columna j
+LAB3_TARGET_AVX2 static inline void Columns_AVX2(const double* a, __m256d c[4])
+{
+    c[0] = _mm256_loadu_pd(a + 0); c[1] = _mm256_loadu_pd(a + 4);
+    c[2] = _mm256_loadu_pd(a + 8); c[3] = _mm256_loadu_pd(a + 12);
+    Transpose4_AVX2(c[0], c[1], c[2], c[3]);
+}
+
+LAB3_TARGET_AVX2 static void Mul4x4Vec_AVX2(const double* a, const double* v, double* r)
+{
+    __m256d c[4];
+    Columns_AVX2(a, c);
+    __m256d acc = _mm256_mul_pd(c[0], _mm256_broadcast_sd(v + 0));
+    acc = _mm256_add_pd(acc, _mm256_mul_pd(c[1], _mm256_broadcast_sd(v + 1)));
+    acc = _mm256_add_pd(acc, _mm256_mul_pd(c[2], _mm256_broadcast_sd(v + 2)));
+    acc = _mm256_add_pd(acc, _mm256_mul_pd(c[3], _mm256_broadcast_sd(v + 3)));
+    _mm256_storeu_pd(r, acc);
+}
+
+LAB3_TARGET_FMA static void Mul4x4_FMA(const double* a, const double* b, double* c)
+{
+    const __m256d b0 = _mm256_loadu_pd(b + 0);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    const __m256d b2 = _mm256_loadu_pd(b + 8);
+    const __m256d b3 = _mm256_loadu_pd(b + 12);
+    for (int i = 0; i < 4; ++i) {
+        __m256d row = _mm256_mul_pd(_mm256_broadcast_sd(a + i * 4 + 0), b0);
+        row = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 1), b1, row);
+        row = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 2), b2, row);
+        row = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 4 + 3), b3, row);
+        _mm256_storeu_pd(c + i * 4, row);
+    }
+}
+
+LAB3_TARGET_FMA static void Mul4x4Vec_FMA(const double* a, const double* v, double* r)
+{
+    __m256d c[4];
+    Columns_AVX2(a, c);
+    __m256d acc = _mm256_mul_pd(c[0], _mm256_broadcast_sd(v + 0));
+    acc = _mm256_fmadd_pd(c[1], _mm256_broadcast_sd(v + 1), acc);
+    acc = _mm256_fmadd_pd(c[2], _mm256_broadcast_sd(v + 2), acc);
+    acc = _mm256_fmadd_pd(c[3], _mm256_broadcast_sd(v + 3), acc);
+    _mm256_storeu_pd(r, acc);
+}
+
+// Versions float: una fila de 4 floats cap en un registre SSE, i AVX2 no aporta
+// res per a un sol producte 4x4, de manera que el nivell AVX2 fa servir SSE.
+LAB3_TARGET_SSE2 static void Mul4x4_SSE2(const float* a, const float* b, float* c)
+{
+    const __m128 b0 = _mm_loadu_ps(b + 0), b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8), b3 = _mm_loadu_ps(b + 12);
+    for (int i = 0; i < 4; ++i) {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 2]), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 3]), b3));
+        _mm_storeu_ps(c + i * 4, row);
+    }
+}
+
+LAB3_TARGET_SSE2 static void Mul4x4Vec_SSE2(const float* a, const float* v, float* r)
+{
+    __m128 c0 = _mm_loadu_ps(a + 0), c1 = _mm_loadu_ps(a + 4);
+    __m128 c2 = _mm_loadu_ps(a + 8), c3 = _mm_loadu_ps(a + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    __m128 acc = _mm_mul_ps(c0, _mm_set1_ps(v[0]));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c1, _mm_set1_ps(v[1])));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c2, _mm_set1_ps(v[2])));
+    acc = _mm_add_ps(acc, _mm_mul_ps(c3, _mm_set1_ps(v[3])));
+    _mm_storeu_ps(r, acc);
+}
+
+static void Mul4x4_AVX2(const float* a, const float* b, float* c) { Mul4x4_SSE2(a, b, c); }
+static void Mul4x4Vec_AVX2(const float* a, const float* v, float* r) { Mul4x4Vec_SSE2(a, v, r); }
+
+LAB3_TARGET_FMA static void Mul4x4_FMA(const float* a, const float* b, float* c)
+{
+    const __m128 b0 = _mm_loadu_ps(b + 0), b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8), b3 = _mm_loadu_ps(b + 12);
+    for (int i = 0; i < 4; ++i) {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), b0);
+        row = _mm_fmadd_ps(_mm_set1_ps(a[i * 4 + 1]), b1, row);
+        row = _mm_fmadd_ps(_mm_set1_ps(a[i * 4 + 2]), b2, row);
+        row = _mm_fmadd_ps(_mm_set1_ps(a[i * 4 + 3]), b3, row);
+        _mm_storeu_ps(c + i * 4, row);
     }
+}
+
+LAB3_TARGET_FMA static void Mul4x4Vec_FMA(const float* a, const float* v, float* r)
+{
+    __m128 c0 = _mm_loadu_ps(a + 0), c1 = _mm_loadu_ps(a + 4);
+    __m128 c2 = _mm_loadu_ps(a + 8), c3 = _mm_loadu_ps(a + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    __m128 acc = _mm_mul_ps(c0, _mm_set1_ps(v[0]));
+    acc = _mm_fmadd_ps(c1, _mm_set1_ps(v[1]), acc);
+    acc = _mm_fmadd_ps(c2, _mm_set1_ps(v[2]), acc);
+    acc = _mm_fmadd_ps(c3, _mm_set1_ps(v[3]), acc);
+    _mm_storeu_ps(r, acc);
+}
+
+#endif
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::MultiplyDispatch(const Matrix4x4T& B) const
+{
+    Matrix4x4T C;
+#if LAB3_SIMD_X86
+    switch (GetSimdLevel()) {
+    case SimdLevel::FMA:  Mul4x4_FMA(m, B.m, C.m);  return C;
+    case SimdLevel::AVX2: Mul4x4_AVX2(m, B.m, C.m); return C;
+    case SimdLevel::SSE2: Mul4x4_SSE2(m, B.m, C.m); return C;
+    default: break;
+    }
+#endif
+    Mul4x4_Scalar(m, B.m, C.m);
     return C;
 }
 
-Vec4 Matrix4x4::Multiply(const Vec4& v) const
+template <typename T>
+Vec4T<T> Matrix4x4T<T>::MultiplyDispatch(const Vec4T<T>& v) const
 {
-    Vec4 res;
-    res.x = At(0, 0) * v.x + At(0, 1) * v.y + At(0, 2) * v.z + At(0, 3) * v.w;
-    res.y = At(1, 0) * v.x + At(1, 1) * v.y + At(1, 2) * v.z + At(1, 3) * v.w;
-    res.z = At(2, 0) * v.x + At(2, 1) * v.y + At(2, 2) * v.z + At(2, 3) * v.w;
-    res.w = At(3, 0) * v.x + At(3, 1) * v.y + At(3, 2) * v.z + At(3, 3) * v.w;
-    return res;
+    const T in[4] = { v.x, v.y, v.z, v.w };
+    T r[4];
+#if LAB3_SIMD_X86
+    switch (GetSimdLevel()) {
+    case SimdLevel::FMA:  Mul4x4Vec_FMA(m, in, r);  break;
+    case SimdLevel::AVX2: Mul4x4Vec_AVX2(m, in, r); break;
+    case SimdLevel::SSE2: Mul4x4Vec_SSE2(m, in, r); break;
+    default: Mul4x4Vec_Scalar(m, in, r); break;
+    }
+#else
+    Mul4x4Vec_Scalar(m, in, r);
+#endif
+    return Vec4T<T>(r[0], r[1], r[2], r[3]);
 }
 
 // --------------------------------------------------------------------------
 // TODO LAB 3
 // --------------------------------------------------------------------------
 
-bool Matrix4x4::IsAffine() const
+template <typename T>
+bool Matrix4x4T<T>::IsAffine() const
 {
-    if (std::abs(At(3, 0)) > TOL) {
+    if (std::abs(At(3, 0)) > Tol<T>()) {
         return false;
     }
-    if (std::abs(At(3, 1)) > TOL) {
+    if (std::abs(At(3, 1)) > Tol<T>()) {
         return false;
     }
-    if (std::abs(At(3, 2)) > TOL) {
+    if (std::abs(At(3, 2)) > Tol<T>()) {
         return false;
     }
-    if (std::abs(At(3, 3) - 1) > TOL) {
+    if (std::abs(At(3, 3) - 1) > Tol<T>()) {
         return false;
     }
     else {
@@ -59,79 +244,502 @@ bool Matrix4x4::IsAffine() const
     }
 }
 
-Vec3 Matrix4x4::TransformPoint(const Vec3& p) const
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::TransformPoint(const Vec3T<T>& p) const
 {
-    Vec4 v4(p.x, p.y, p.z, 1.0f);
-    Vec4 res = Multiply(v4);
-    if (std::abs(res.w) > TOL && std::abs(res.w - 1.0f) > TOL) {
-        float div = 1.0f / res.w;
-        return Vec3(res.x * div, res.y * div, res.z * div);
+    Vec4T<T> v4(p.x, p.y, p.z, T(1));
+    Vec4T<T> res = Multiply(v4);
+    if (std::abs(res.w) > Tol<T>() && std::abs(res.w - T(1)) > Tol<T>()) {
+        T div = T(1) / res.w;
+        return Vec3T<T>(res.x * div, res.y * div, res.z * div);
     }
-    Vec3 result = Vec3(res.x, res.y, res.z);
+    Vec3T<T> result = Vec3T<T>(res.x, res.y, res.z);
     return result;
 }
 
-Vec3 Matrix4x4::TransformVector(const Vec3& v) const
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::TransformVector(const Vec3T<T>& v) const
 {
-    Vec4 v4(v.x, v.y, v.z, 0.0f);
+    Vec4T<T> v4(v.x, v.y, v.z, T(0));
+
+    Vec4T<T> result = this->Multiply(v4);
+
+    return Vec3T<T>(result.x, result.y, result.z);
+}
 
-    Vec4 result = this->Multiply(v4);
+// --------------------------------------------------------------------------
+// Transformacions en lot
+// --------------------------------------------------------------------------
 
-    return Vec3(result.x, result.y, result.z);
+static void CheckBatchSize(std::size_t n, std::size_t n_out)
+{
+    if (n != n_out) {
+        throw std::invalid_argument("Transformacio en lot: mides d'entrada i sortida diferents");
+    }
 }
 
-Matrix4x4 Matrix4x4::Translate(const Vec3& t)
+template <typename T>
+void Matrix4x4T<T>::TransformPoints(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const
 {
-    Matrix4x4 M = Matrix4x4::Identity();
+    CheckBatchSize(in.size(), out.size());
+    if (!IsAffine()) {
+        // Cas projectiu: mateix resultat que TransformPoint punt a punt
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            out[i] = TransformPoint(in[i]);
+        }
+        return;
+    }
 
-    M.At(0,3) = t.x;
-    M.At(1,3) = t.y;
-    M.At(2,3) = t.z;
+    const T m00 = At(0, 0), m01 = At(0, 1), m02 = At(0, 2), m03 = At(0, 3);
+    const T m10 = At(1, 0), m11 = At(1, 1), m12 = At(1, 2), m13 = At(1, 3);
+    const T m20 = At(2, 0), m21 = At(2, 1), m22 = At(2, 2), m23 = At(2, 3);
 
-    return M;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        const Vec3T<T> p = in[i];
+        out[i] = { m00 * p.x + m01 * p.y + m02 * p.z + m03,
+                   m10 * p.x + m11 * p.y + m12 * p.z + m13,
+                   m20 * p.x + m21 * p.y + m22 * p.z + m23 };
+    }
 }
 
-Matrix4x4 Matrix4x4::Scale(const Vec3& s)
+template <typename T>
+void Matrix4x4T<T>::TransformVectors(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const
 {
-    Matrix4x4 M = Matrix4x4::Identity();
+    CheckBatchSize(in.size(), out.size());
 
-    M.At(0, 0) = s.x;  
-    M.At(1, 1) = s.y;  
-    M.At(2, 2) = s.z;  
+    const T m00 = At(0, 0), m01 = At(0, 1), m02 = At(0, 2);
+    const T m10 = At(1, 0), m11 = At(1, 1), m12 = At(1, 2);
+    const T m20 = At(2, 0), m21 = At(2, 1), m22 = At(2, 2);
 
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        const Vec3T<T> v = in[i];
+        out[i] = { m00 * v.x + m01 * v.y + m02 * v.z,
+                   m10 * v.x + m11 * v.y + m12 * v.z,
+                   m20 * v.x + m21 * v.y + m22 * v.z };
+    }
+}
 
-    return M;
+template <typename T>
+void Matrix4x4T<T>::TransformPoints(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                                std::span<T> ox, std::span<T> oy, std::span<T> oz) const
+{
+    const std::size_t n = x.size();
+    CheckBatchSize(n, y.size()); CheckBatchSize(n, z.size());
+    CheckBatchSize(n, ox.size()); CheckBatchSize(n, oy.size()); CheckBatchSize(n, oz.size());
+
+    const T m00 = At(0, 0), m01 = At(0, 1), m02 = At(0, 2), m03 = At(0, 3);
+    const T m10 = At(1, 0), m11 = At(1, 1), m12 = At(1, 2), m13 = At(1, 3);
+    const T m20 = At(2, 0), m21 = At(2, 1), m22 = At(2, 2), m23 = At(2, 3);
+
+    if (IsAffine()) {
+        // Bucle sense branques sobre arrays separats: el compilador el vectoritza
+        for (std::size_t i = 0; i < n; ++i) {
+            const T px = x[i], py = y[i], pz = z[i];
+            ox[i] = m00 * px + m01 * py + m02 * pz + m03;
+            oy[i] = m10 * px + m11 * py + m12 * pz + m13;
+            oz[i] = m20 * px + m21 * py + m22 * pz + m23;
+        }
+        return;
+    }
+
+    const T m30 = At(3, 0), m31 = At(3, 1), m32 = At(3, 2), m33 = At(3, 3);
+    for (std::size_t i = 0; i < n; ++i) {
+        const T px = x[i], py = y[i], pz = z[i];
+        const T w = m30 * px + m31 * py + m32 * pz + m33;
+        // Mateix criteri que TransformPoint: nomes es divideix si w no es ~0 ni ~1
+        const T inv = (std::abs(w) > Tol<T>() && std::abs(w - T(1)) > Tol<T>()) ? T(1) / w : T(1);
+        ox[i] = (m00 * px + m01 * py + m02 * pz + m03) * inv;
+        oy[i] = (m10 * px + m11 * py + m12 * pz + m13) * inv;
+        oz[i] = (m20 * px + m21 * py + m22 * pz + m23) * inv;
+    }
 }
 
-Matrix4x4 Matrix4x4::Rotate(const Matrix3x3& R)
+template <typename T>
+void Matrix4x4T<T>::TransformVectors(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                                 std::span<T> ox, std::span<T> oy, std::span<T> oz) const
 {
-    Matrix4x4 M = Matrix4x4::Identity();
+    const std::size_t n = x.size();
+    CheckBatchSize(n, y.size()); CheckBatchSize(n, z.size());
+    CheckBatchSize(n, ox.size()); CheckBatchSize(n, oy.size()); CheckBatchSize(n, oz.size());
 
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            M.At(i, j) = R.At(i, j);
+    const T m00 = At(0, 0), m01 = At(0, 1), m02 = At(0, 2);
+    const T m10 = At(1, 0), m11 = At(1, 1), m12 = At(1, 2);
+    const T m20 = At(2, 0), m21 = At(2, 1), m22 = At(2, 2);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const T vx = x[i], vy = y[i], vz = z[i];
+        ox[i] = m00 * vx + m01 * vy + m02 * vz;
+        oy[i] = m10 * vx + m11 * vy + m12 * vz;
+        oz[i] = m20 * vx + m21 * vy + m22 * vz;
+    }
+}
+
+// --------------------------------------------------------------------------
+// Projeccio a NDC
+// --------------------------------------------------------------------------
+
+#if LAB3_SIMD_X86
+// AoS: un punt per iteracio, un carril per fila (x', y', z', w')
+LAB3_TARGET_AVX2 static void ProjectAoS_AVX2(const double* a, const Vec3T<double>* in, Vec3T<double>* out, std::size_t n)
+{
+    __m256d c[4];
+    Columns_AVX2(a, c);
+    for (std::size_t i = 0; i < n; ++i) {
+        const Vec3T<double> p = in[i];
+        __m256d r = _mm256_add_pd(_mm256_mul_pd(c[0], _mm256_set1_pd(p.x)), _mm256_mul_pd(c[1], _mm256_set1_pd(p.y)));
+        r = _mm256_add_pd(r, _mm256_add_pd(_mm256_mul_pd(c[2], _mm256_set1_pd(p.z)), c[3]));
+        const __m256d w = _mm256_permute4x64_pd(r, 0xFF);
+        r = _mm256_div_pd(r, w);
+        alignas(32) double tmp[4];
+        _mm256_store_pd(tmp, r);
+        out[i] = { tmp[0], tmp[1], tmp[2] };
+    }
+}
+
+// SoA: quatre punts per iteracio, un carril per punt. Retorna quants n'ha fet.
+LAB3_TARGET_AVX2 static std::size_t ProjectSoA_AVX2(const double* a, const double* x, const double* y, const double* z,
+                                                    double* ox, double* oy, double* oz, double* ow, std::size_t n)
+{
+    __m256d m[16];
+    for (int k = 0; k < 16; ++k) {
+        m[k] = _mm256_set1_pd(a[k]);
+    }
+#define ROW(r) _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m[4 * r], px), _mm256_mul_pd(m[4 * r + 1], py)), \
+                             _mm256_add_pd(_mm256_mul_pd(m[4 * r + 2], pz), m[4 * r + 3]))
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d px = _mm256_loadu_pd(x + i), py = _mm256_loadu_pd(y + i), pz = _mm256_loadu_pd(z + i);
+        const __m256d w = ROW(3);
+        const __m256d inv = _mm256_div_pd(_mm256_set1_pd(1.0), w);
+        _mm256_storeu_pd(ox + i, _mm256_mul_pd(ROW(0), inv));
+        _mm256_storeu_pd(oy + i, _mm256_mul_pd(ROW(1), inv));
+        _mm256_storeu_pd(oz + i, _mm256_mul_pd(ROW(2), inv));
+        if (ow) _mm256_storeu_pd(ow + i, w);
+    }
+#undef ROW
+    return i;
+}
+#endif
+
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::ProjectToNDC(const Vec3T<T>& p) const
+{
+    const T w = At(3, 0) * p.x + At(3, 1) * p.y + At(3, 2) * p.z + At(3, 3);
+    return { (At(0, 0) * p.x + At(0, 1) * p.y + At(0, 2) * p.z + At(0, 3)) / w,
+             (At(1, 0) * p.x + At(1, 1) * p.y + At(1, 2) * p.z + At(1, 3)) / w,
+             (At(2, 0) * p.x + At(2, 1) * p.y + At(2, 2) * p.z + At(2, 3)) / w };
+}
+
+template <typename T>
+void Matrix4x4T<T>::ProjectToNDC(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const
+{
+    CheckBatchSize(in.size(), out.size());
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            ProjectAoS_AVX2(m, in.data(), out.data(), in.size());
+            return;
         }
     }
+#endif
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = ProjectToNDC(in[i]);
+    }
+}
 
-    return M;
+template <typename T>
+void Matrix4x4T<T>::ProjectToNDC(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                                 std::span<T> ox, std::span<T> oy, std::span<T> oz, std::span<T> ow) const
+{
+    const std::size_t n = x.size();
+    CheckBatchSize(n, y.size()); CheckBatchSize(n, z.size());
+    CheckBatchSize(n, ox.size()); CheckBatchSize(n, oy.size()); CheckBatchSize(n, oz.size());
+    if (!ow.empty()) CheckBatchSize(n, ow.size());
+    T* pw = ow.empty() ? nullptr : ow.data();
+
+    std::size_t i = 0;
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            i = ProjectSoA_AVX2(m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), pw, n);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        const T px = x[i], py = y[i], pz = z[i];
+        const T w = At(3, 0) * px + At(3, 1) * py + At(3, 2) * pz + At(3, 3);
+        const T inv = T(1) / w;
+        ox[i] = (At(0, 0) * px + At(0, 1) * py + At(0, 2) * pz + At(0, 3)) * inv;
+        oy[i] = (At(1, 0) * px + At(1, 1) * py + At(1, 2) * pz + At(1, 3)) * inv;
+        oz[i] = (At(2, 0) * px + At(2, 1) * py + At(2, 2) * pz + At(2, 3)) * inv;
+        if (pw) pw[i] = w;
+    }
+}
+
+// --------------------------------------------------------------------------
+// Matriu de normals
+// --------------------------------------------------------------------------
+
+// Columnes de la matriu de cofactors de la part 3x3 (a0, a1, a2 les seves
+// columnes): a1 x a2, a2 x a0, a0 x a1. Retorna det = a0 . (a1 x a2).
+template <typename T>
+static T Cofactor3x3(const Matrix4x4T<T>& M, Matrix3x3T<T>& C)
+{
+    const Vec3T<T> a0{ M.At(0, 0), M.At(1, 0), M.At(2, 0) };
+    const Vec3T<T> a1{ M.At(0, 1), M.At(1, 1), M.At(2, 1) };
+    const Vec3T<T> a2{ M.At(0, 2), M.At(1, 2), M.At(2, 2) };
+    const Vec3T<T> c[3] = { Vec3T<T>::Cross(a1, a2), Vec3T<T>::Cross(a2, a0), Vec3T<T>::Cross(a0, a1) };
+    for (int j = 0; j < 3; ++j) {
+        C.At(0, j) = c[j].x;
+        C.At(1, j) = c[j].y;
+        C.At(2, j) = c[j].z;
+    }
+    return Vec3T<T>::Dot(a0, c[0]);
+}
+
+template <typename T>
+Matrix3x3T<T> Matrix4x4T<T>::NormalMatrix() const
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
+    }
+    Matrix3x3T<T> C;
+    if (Cofactor3x3(*this, C) < 0) {
+        for (T& e : C.m) e = -e;
+    }
+    return C;
+}
+
+template <typename T>
+Matrix3x3T<T> Matrix4x4T<T>::NormalMatrixExact() const
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
+    }
+    Matrix3x3T<T> C;
+    const T det = Cofactor3x3(*this, C);
+    // Mateix criteri relatiu que Inverse (fita de Hadamard)
+    T bound2 = 1;
+    for (int j = 0; j < 3; ++j) {
+        bound2 *= At(0, j) * At(0, j) + At(1, j) * At(1, j) + At(2, j) * At(2, j);
+    }
+    const T rel = T(64) * std::numeric_limits<T>::epsilon();
+    if (!(det * det > rel * rel * bound2)) {
+        throw std::runtime_error("La matriu s singular");
+    }
+    const T inv = T(1) / det;
+    for (T& e : C.m) e *= inv;
+    return C;
+}
+
+// Referencia escalar: N * n / |N * n|, o zero
+template <typename T>
+static void TransformNormal(const T* N, T x, T y, T z, T& ox, T& oy, T& oz)
+{
+    const T nx = N[0] * x + N[1] * y + N[2] * z;
+    const T ny = N[3] * x + N[4] * y + N[5] * z;
+    const T nz = N[6] * x + N[7] * y + N[8] * z;
+    const T len2 = nx * nx + ny * ny + nz * nz;
+    const T inv = (len2 > 0) ? T(1) / std::sqrt(len2) : T(0);
+    ox = nx * inv;
+    oy = ny * inv;
+    oz = nz * inv;
+}
+
+#if LAB3_SIMD_X86
+// 1/sqrt per carril. En double no hi ha rsqrt: es fa en float (12 bits) i
+// dos passos de Newton (~1e-13). Nomes per a x dins del rang de float.
+LAB3_TARGET_AVX2 static inline __m256d Rsqrt_AVX2(__m256d x)
+{
+    const __m256d hx = _mm256_mul_pd(_mm256_set1_pd(0.5), x), three = _mm256_set1_pd(1.5);
+    __m256d y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(x)));
+    y = _mm256_mul_pd(y, _mm256_sub_pd(three, _mm256_mul_pd(hx, _mm256_mul_pd(y, y))));
+    y = _mm256_mul_pd(y, _mm256_sub_pd(three, _mm256_mul_pd(hx, _mm256_mul_pd(y, y))));
+    return y;
+}
+
+// En float n'hi ha prou amb un pas de Newton (~5e-7)
+LAB3_TARGET_AVX2 static inline __m256 Rsqrt_AVX2(__m256 x)
+{
+    const __m256 hx = _mm256_mul_ps(_mm256_set1_ps(0.5f), x), three = _mm256_set1_ps(1.5f);
+    const __m256 y = _mm256_rsqrt_ps(x);
+    return _mm256_mul_ps(y, _mm256_sub_ps(three, _mm256_mul_ps(hx, _mm256_mul_ps(y, y))));
 }
 
-Matrix4x4 Matrix4x4::Rotate(const Quat& q)
+// Operacions per carril sobrecarregades per a double (4) i float (8), perque
+// el kernel de normals sigui el mateix per als dos tipus
+LAB3_TARGET_AVX2 static inline __m256d Set1_AVX2(double a) { return _mm256_set1_pd(a); }
+LAB3_TARGET_AVX2 static inline __m256 Set1_AVX2(float a) { return _mm256_set1_ps(a); }
+LAB3_TARGET_AVX2 static inline __m256d LoadU_AVX2(const double* p) { return _mm256_loadu_pd(p); }
+LAB3_TARGET_AVX2 static inline __m256 LoadU_AVX2(const float* p) { return _mm256_loadu_ps(p); }
+LAB3_TARGET_AVX2 static inline void StoreU_AVX2(double* p, __m256d a) { _mm256_storeu_pd(p, a); }
+LAB3_TARGET_AVX2 static inline void StoreU_AVX2(float* p, __m256 a) { _mm256_storeu_ps(p, a); }
+LAB3_TARGET_AVX2 static inline __m256d Add_AVX2(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+LAB3_TARGET_AVX2 static inline __m256 Add_AVX2(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+LAB3_TARGET_AVX2 static inline __m256d Mul_AVX2(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+LAB3_TARGET_AVX2 static inline __m256 Mul_AVX2(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+// Cert si tots els carrils estan dins de [lo, hi]
+LAB3_TARGET_AVX2 static inline bool AllInRange_AVX2(__m256d a, __m256d lo, __m256d hi)
 {
-    Matrix4x4 M;
-    Matrix3x3 R;
+    return _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(a, lo, _CMP_GE_OQ), _mm256_cmp_pd(a, hi, _CMP_LE_OQ))) == 0xF;
+}
+LAB3_TARGET_AVX2 static inline bool AllInRange_AVX2(__m256 a, __m256 lo, __m256 hi)
+{
+    return _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(a, lo, _CMP_GE_OQ), _mm256_cmp_ps(a, hi, _CMP_LE_OQ))) == 0xFF;
+}
+
+// AoS <-> SoA: 4 Vec3 en double son tres registres [x0 y0 z0 x1] [y1 z1 x2 y2]
+// [z2 x3 y3 z3]; es reordenen amb blends i shuffles, sense passar per memoria
+LAB3_TARGET_AVX2 static inline void Load3_AVX2(const double* p, __m256d& x, __m256d& y, __m256d& z)
+{
+    const __m256d r0 = _mm256_loadu_pd(p), r1 = _mm256_loadu_pd(p + 4), r2 = _mm256_loadu_pd(p + 8);
+    const __m256d a = _mm256_blend_pd(r0, r1, 0xC);            // x0 y0 x2 y2
+    const __m256d b = _mm256_permute2f128_pd(r0, r2, 0x21);    // z0 x1 z2 x3
+    const __m256d c = _mm256_blend_pd(r1, r2, 0xC);            // y1 z1 y3 z3
+    x = _mm256_blend_pd(a, b, 0xA);
+    y = _mm256_shuffle_pd(a, c, 0x5);
+    z = _mm256_blend_pd(b, c, 0xA);
+}
+
+LAB3_TARGET_AVX2 static inline void Store3_AVX2(double* p, __m256d x, __m256d y, __m256d z)
+{
+    const __m256d a = _mm256_unpacklo_pd(x, y);                // x0 y0 x2 y2
+    const __m256d b = _mm256_blend_pd(z, x, 0xA);              // z0 x1 z2 x3
+    const __m256d c = _mm256_unpackhi_pd(y, z);                // y1 z1 y3 z3
+    _mm256_storeu_pd(p, _mm256_permute2f128_pd(a, b, 0x20));
+    _mm256_storeu_pd(p + 4, _mm256_blend_pd(c, a, 0xC));
+    _mm256_storeu_pd(p + 8, _mm256_permute2f128_pd(b, c, 0x31));
+}
+
+// 8 Vec3 en float: cada meitat de 128 bits fa 4 Vec3 amb el mateix patro
+LAB3_TARGET_AVX2 static inline void Load3_AVX2(const float* p, __m256& x, __m256& y, __m256& z)
+{
+    const __m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+    const __m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+    const __m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+    const __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));   // x2 y2 x3 y3
+    const __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));   // y0 z0 y1 z1
+    x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+LAB3_TARGET_AVX2 static inline void Store3_AVX2(float* p, __m256 x, __m256 y, __m256 z)
+{
+    const __m256 xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));       // x0 x2 y0 y2
+    const __m256 yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));       // y1 y3 z1 z3
+    const __m256 zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));       // z0 z2 x1 x3
+    const __m256 m03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 m14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256 m25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm_storeu_ps(p, _mm256_castps256_ps128(m03));
+    _mm_storeu_ps(p + 4, _mm256_castps256_ps128(m14));
+    _mm_storeu_ps(p + 8, _mm256_castps256_ps128(m25));
+    _mm_storeu_ps(p + 12, _mm256_extractf128_ps(m03, 1));
+    _mm_storeu_ps(p + 16, _mm256_extractf128_ps(m14, 1));
+    _mm_storeu_ps(p + 20, _mm256_extractf128_ps(m25, 1));
+}
+
+// W normals per iteracio (4 en double, 8 en float), un carril per normal.
+// AoS: in i out apunten a Vec3 consecutius; SoA: x, y, z separats. Els grups
+// amb alguna longitud fora de [1e-30, 1e30] (rsqrt no es fiable o la normal
+// es nul.la) es fan amb la referencia escalar. Retorna quantes n'ha fet.
+template <bool AoS, typename S>
+LAB3_TARGET_AVX2 static std::size_t Normals_AVX2(const S* N, const S* x, const S* y, const S* z,
+                                                 S* ox, S* oy, S* oz, std::size_t n)
+{
+    using V = decltype(Set1_AVX2(S(0)));
+    constexpr std::size_t W = sizeof(V) / sizeof(S);
+    constexpr std::size_t step = AoS ? 3 : 1;
+    V c[9];
+    for (int k = 0; k < 9; ++k) c[k] = Set1_AVX2(N[k]);
+    const V lo = Set1_AVX2(S(1e-30)), hi = Set1_AVX2(S(1e30));
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        V vx, vy, vz;
+        if constexpr (AoS) {
+            Load3_AVX2(x + 3 * i, vx, vy, vz);
+        } else {
+            vx = LoadU_AVX2(x + i); vy = LoadU_AVX2(y + i); vz = LoadU_AVX2(z + i);
+        }
+        const V nx = Add_AVX2(Add_AVX2(Mul_AVX2(c[0], vx), Mul_AVX2(c[1], vy)), Mul_AVX2(c[2], vz));
+        const V ny = Add_AVX2(Add_AVX2(Mul_AVX2(c[3], vx), Mul_AVX2(c[4], vy)), Mul_AVX2(c[5], vz));
+        const V nz = Add_AVX2(Add_AVX2(Mul_AVX2(c[6], vx), Mul_AVX2(c[7], vy)), Mul_AVX2(c[8], vz));
+        const V len2 = Add_AVX2(Add_AVX2(Mul_AVX2(nx, nx), Mul_AVX2(ny, ny)), Mul_AVX2(nz, nz));
+        if (!AllInRange_AVX2(len2, lo, hi)) {
+            for (std::size_t l = 0; l < W; ++l) {
+                const std::size_t k = (i + l) * step;
+                TransformNormal(N, x[k], y[k], z[k], ox[k], oy[k], oz[k]);
+            }
+            continue;
+        }
+        const V inv = Rsqrt_AVX2(len2);
+        if constexpr (AoS) {
+            Store3_AVX2(ox + 3 * i, Mul_AVX2(nx, inv), Mul_AVX2(ny, inv), Mul_AVX2(nz, inv));
+        } else {
+            StoreU_AVX2(ox + i, Mul_AVX2(nx, inv)); StoreU_AVX2(oy + i, Mul_AVX2(ny, inv)); StoreU_AVX2(oz + i, Mul_AVX2(nz, inv));
+        }
+    }
+    return i;
+}
+#endif
+
+template <typename T>
+void Matrix4x4T<T>::TransformNormals(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const
+{
+    CheckBatchSize(in.size(), out.size());
+    const Matrix3x3T<T> N = NormalMatrix();
+    const std::size_t n = in.size();
+    if (n == 0) return;
+    std::size_t i = 0;
+#if LAB3_SIMD_X86
+    if (GetSimdLevel() >= SimdLevel::AVX2) {
+        i = Normals_AVX2<true>(N.m, &in[0].x, &in[0].y, &in[0].z, &out[0].x, &out[0].y, &out[0].z, n);
+    }
+#endif
+    for (; i < n; ++i) {
+        const Vec3T<T> v = in[i];
+        TransformNormal(N.m, v.x, v.y, v.z, out[i].x, out[i].y, out[i].z);
+    }
+}
+
+template <typename T>
+void Matrix4x4T<T>::TransformNormals(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                                     std::span<T> ox, std::span<T> oy, std::span<T> oz) const
+{
+    const std::size_t n = x.size();
+    CheckBatchSize(n, y.size()); CheckBatchSize(n, z.size());
+    CheckBatchSize(n, ox.size()); CheckBatchSize(n, oy.size()); CheckBatchSize(n, oz.size());
+    const Matrix3x3T<T> N = NormalMatrix();
+    std::size_t i = 0;
+#if LAB3_SIMD_X86
+    if (GetSimdLevel() >= SimdLevel::AVX2) {
+        i = Normals_AVX2<false>(N.m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), n);
+    }
+#endif
+    for (; i < n; ++i) {
+        TransformNormal(N.m, x[i], y[i], z[i], ox[i], oy[i], oz[i]);
+    }
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::Rotate(const QuatT<T>& q)
+{
+    Matrix4x4T M;
+    Matrix3x3T<T> R;
     R = q.ToMatrix3x3();
     M = Rotate(R);
 
     return M;
 }
 
-Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s)
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::FromTRS(const Vec3T<T>& t, const Matrix3x3T<T>& R, const Vec3T<T>& s)
 {
-    Matrix4x4 M;
+    Matrix4x4T M;
     M = Rotate(R);
 
-    float scales[3] = { s.x, s.y, s.z };
+    T scales[3] = { s.x, s.y, s.z };
 
     for (int j = 0; j < 3; ++j)
     {
@@ -148,12 +756,13 @@ Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Matrix3x3& R, const Vec3& s)
     return M;
 }
 
-Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::FromTRS(const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s)
 {
-    Matrix4x4 M;
+    Matrix4x4T M;
     M = Rotate(q);
 
-    float scales[3] = { s.x, s.y, s.z };
+    T scales[3] = { s.x, s.y, s.z };
 
     for (int j = 0; j < 3; ++j)
     {
@@ -170,222 +779,727 @@ Matrix4x4 Matrix4x4::FromTRS(const Vec3& t, const Quat& q, const Vec3& s)
     return M;
 }
 
-Matrix4x4 Matrix4x4::InverseTR() const
+// --------------------------------------------------------------------------
+// Camera
+// --------------------------------------------------------------------------
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::Perspective(T fovY, T aspect, T zNear, T zFar)
+{
+    if (!(fovY > 0 && fovY < T(PI)) || !(aspect > 0) || !(zNear > 0) || !(zFar > zNear)) {
+        throw std::invalid_argument("Perspective: parametres degenerats");
+    }
+    const T f = T(1) / std::tan(fovY * T(0.5));
+    Matrix4x4T M;
+    M.At(0, 0) = f / aspect;
+    M.At(1, 1) = f;
+    M.At(2, 2) = (zFar + zNear) / (zNear - zFar);
+    M.At(2, 3) = T(2) * zFar * zNear / (zNear - zFar);
+    M.At(3, 2) = T(-1);
+    return M;
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::Orthographic(T left, T right, T bottom, T top, T zNear, T zFar)
+{
+    if (right == left || top == bottom || zFar == zNear) {
+        throw std::invalid_argument("Orthographic: volum buit");
+    }
+    Matrix4x4T M;
+    M.At(0, 0) = T(2) / (right - left);
+    M.At(1, 1) = T(2) / (top - bottom);
+    M.At(2, 2) = T(-2) / (zFar - zNear);
+    M.At(0, 3) = -(right + left) / (right - left);
+    M.At(1, 3) = -(top + bottom) / (top - bottom);
+    M.At(2, 3) = -(zFar + zNear) / (zFar - zNear);
+    M.At(3, 3) = T(1);
+    return M;
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::LookAt(const Vec3T<T>& eye, const Vec3T<T>& target, const Vec3T<T>& up)
+{
+    const Vec3T<T> d{ target.x - eye.x, target.y - eye.y, target.z - eye.z };
+    const Vec3T<T> side = Vec3T<T>::Cross(d, up);
+    if (d.Norm() <= Tol<T>() || side.Norm() <= Tol<T>() * d.Norm() * up.Norm()) {
+        throw std::invalid_argument("LookAt: eye == target o up paral.lel a la direccio");
+    }
+    const Vec3T<T> f = d.Normalize();
+    const Vec3T<T> s = side.Normalize();
+    const Vec3T<T> u = Vec3T<T>::Cross(s, f);
+
+    Matrix4x4T M;
+    M.At(0, 0) = s.x;  M.At(0, 1) = s.y;  M.At(0, 2) = s.z;  M.At(0, 3) = -Vec3T<T>::Dot(s, eye);
+    M.At(1, 0) = u.x;  M.At(1, 1) = u.y;  M.At(1, 2) = u.z;  M.At(1, 3) = -Vec3T<T>::Dot(u, eye);
+    M.At(2, 0) = -f.x; M.At(2, 1) = -f.y; M.At(2, 2) = -f.z; M.At(2, 3) = Vec3T<T>::Dot(f, eye);
+    M.At(3, 3) = T(1);
+    return M;
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::InverseTR() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix4x4 M;
-    Matrix3x3 R;
+    Matrix4x4T M;
+    Matrix3x3T<T> R;
     for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
             R.At(i, j) = At(j, i);
         }
     }
 
-    Vec3 p(At(0, 3), At(1, 3), At(2, 3));
-    Vec3 pi;
+    Vec3T<T> p(At(0, 3), At(1, 3), At(2, 3));
+    Vec3T<T> pi;
     pi.x = -(R.At(0, 0) * p.x + R.At(0, 1) * p.y + R.At(0, 2) * p.z);
     pi.y = -(R.At(1, 0) * p.x + R.At(1, 1) * p.y + R.At(1, 2) * p.z);
     pi.z = -(R.At(2, 0) * p.x + R.At(2, 1) * p.y + R.At(2, 2) * p.z);
 
-    M = FromTRS(pi, R, Vec3(1.0f, 1.0f, 1.0f));
+    M = FromTRS(pi, R, Vec3T<T>(T(1), T(1), T(1)));
     return M;
 }
 
-Matrix4x4 Matrix4x4::InverseTRS() const
+template <typename T>
+static void InverseTRSUnchecked(const Matrix4x4T<T>& A, Matrix4x4T<T>& M)
+{
+    // (R*S)^-1 = S^-1 * R^T: la fila j de la inversa es la columna j / s_j^2.
+    // Columnes amb escala ~0 donen una fila de zeros, com GetRotation.
+    M = Matrix4x4T<T>();
+    for (int j = 0; j < 3; ++j) {
+        const T c0 = A.At(0, j), c1 = A.At(1, j), c2 = A.At(2, j);
+        const T n2 = c0 * c0 + c1 * c1 + c2 * c2;
+        const T inv = (n2 > Tol<T>() * Tol<T>()) ? T(1) / n2 : T(0);
+        M.At(j, 0) = c0 * inv;
+        M.At(j, 1) = c1 * inv;
+        M.At(j, 2) = c2 * inv;
+    }
+    for (int i = 0; i < 3; ++i) {
+        M.At(i, 3) = -(M.At(i, 0) * A.At(0, 3) + M.At(i, 1) * A.At(1, 3) + M.At(i, 2) * A.At(2, 3));
+    }
+    M.At(3, 3) = 1;
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::InverseTRS() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix4x4 M; 
-    Vec3 s = GetScale();
-    Matrix3x3 R = GetRotation();
-    Vec3 t = GetTranslation();
+    Matrix4x4T M;
+    InverseTRSUnchecked(*this, M);
+    return M;
+}
 
-    Vec3 inversaesc;
-    if (std::abs(s.x) > TOL) {
-        inversaesc.x = 1.0 / s.x;
+template <typename T>
+void Matrix4x4T<T>::InverseTRSMany(std::span<const Matrix4x4T> in, std::span<Matrix4x4T> out)
+{
+    CheckBatchSize(in.size(), out.size());
+    for (const Matrix4x4T& A : in) {
+        if (!A.IsAffine()) {
+            throw std::runtime_error("La matriu no s af");
+        }
     }
-    else {
-        inversaesc.x = 0.0;
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        Matrix4x4T M;
+        InverseTRSUnchecked(in[i], M);
+        out[i] = M;
     }
-    if (std::abs(s.y) > TOL) {
-        inversaesc.y = 1.0 / s.y;
+}
+
+// --------------------------------------------------------------------------
+// Inversa general per cofactors
+// --------------------------------------------------------------------------
+
+// Adjunta (transposada de la matriu de cofactors) a partir dels menors 2x2 de
+// les files 0-1 (s) i 2-3 (c). Retorna el determinant.
+template <typename T>
+static T Adjugate4x4(const T* a, T* b)
+{
+    const T s0 = a[0] * a[5] - a[4] * a[1];
+    const T s1 = a[0] * a[6] - a[4] * a[2];
+    const T s2 = a[0] * a[7] - a[4] * a[3];
+    const T s3 = a[1] * a[6] - a[5] * a[2];
+    const T s4 = a[1] * a[7] - a[5] * a[3];
+    const T s5 = a[2] * a[7] - a[6] * a[3];
+
+    const T c5 = a[10] * a[15] - a[14] * a[11];
+    const T c4 = a[9] * a[15] - a[13] * a[11];
+    const T c3 = a[9] * a[14] - a[13] * a[10];
+    const T c2 = a[8] * a[15] - a[12] * a[11];
+    const T c1 = a[8] * a[14] - a[12] * a[10];
+    const T c0 = a[8] * a[13] - a[12] * a[9];
+
+    b[0] = a[5] * c5 - a[6] * c4 + a[7] * c3;
+    b[1] = -a[1] * c5 + a[2] * c4 - a[3] * c3;
+    b[2] = a[13] * s5 - a[14] * s4 + a[15] * s3;
+    b[3] = -a[9] * s5 + a[10] * s4 - a[11] * s3;
+
+    b[4] = -a[4] * c5 + a[6] * c2 - a[7] * c1;
+    b[5] = a[0] * c5 - a[2] * c2 + a[3] * c1;
+    b[6] = -a[12] * s5 + a[14] * s2 - a[15] * s1;
+    b[7] = a[8] * s5 - a[10] * s2 + a[11] * s1;
+
+    b[8] = a[4] * c4 - a[5] * c2 + a[7] * c0;
+    b[9] = -a[0] * c4 + a[1] * c2 - a[3] * c0;
+    b[10] = a[12] * s4 - a[13] * s2 + a[15] * s0;
+    b[11] = -a[8] * s4 + a[9] * s2 - a[11] * s0;
+
+    b[12] = -a[4] * c3 + a[5] * c1 - a[6] * c0;
+    b[13] = a[0] * c3 - a[1] * c1 + a[2] * c0;
+    b[14] = -a[12] * s3 + a[13] * s1 - a[14] * s0;
+    b[15] = a[8] * s3 - a[9] * s1 + a[10] * s0;
+
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+// Criteri de singularitat independent de l'escala: |det| comparat amb la cota
+// de Hadamard (producte de les normes de les files).
+template <typename T>
+static bool IsSingular4x4(const T* a, T det)
+{
+    T bound2 = 1;
+    for (int i = 0; i < 4; ++i) {
+        bound2 *= a[i * 4 + 0] * a[i * 4 + 0] + a[i * 4 + 1] * a[i * 4 + 1]
+                + a[i * 4 + 2] * a[i * 4 + 2] + a[i * 4 + 3] * a[i * 4 + 3];
     }
-    else {
-        inversaesc.y = 0.0;
+    const T rel = T(64) * std::numeric_limits<T>::epsilon();
+    return !(det * det > rel * rel * bound2);
+}
+
+template <typename T>
+T Matrix4x4T<T>::Det() const
+{
+    T adj[16];
+    return Adjugate4x4(m, adj);
+}
+
+template <typename T>
+Expected<Matrix4x4T<T>> Matrix4x4T<T>::TryInverse() const
+{
+    Matrix4x4T M;
+    const T det = Adjugate4x4(m, M.m);
+    if (IsSingular4x4(m, det)) return MathError::Singular;
+    const T inv = T(1) / det;
+    for (int k = 0; k < 16; ++k) M.m[k] *= inv;
+    return M;
+}
+
+template <typename T>
+Matrix4x4T<T> Matrix4x4T<T>::Inverse() const
+{
+    Expected<Matrix4x4T> M = TryInverse();
+    if (!M) {
+        throw std::runtime_error("La matriu s singular");
     }
-    if (std::abs(s.z) > TOL) {
-        inversaesc.z = 1.0 / s.z;
+    return *M;
+}
+
+#if LAB3_SIMD_X86
+
+// Quatre matrius alhora: cada carril d'un registre AVX es una matriu diferent.
+// Les files es transposen perque a[k] tingui l'element k de les quatre matrius.
+LAB3_TARGET_AVX2 static void LoadLanes_AVX2(const double* m0, const double* m1, const double* m2,
+                                            const double* m3, __m256d a[16])
+{
+    for (int r = 0; r < 4; ++r) {
+        a[r * 4 + 0] = _mm256_loadu_pd(m0 + r * 4);
+        a[r * 4 + 1] = _mm256_loadu_pd(m1 + r * 4);
+        a[r * 4 + 2] = _mm256_loadu_pd(m2 + r * 4);
+        a[r * 4 + 3] = _mm256_loadu_pd(m3 + r * 4);
+        Transpose4_AVX2(a[r * 4 + 0], a[r * 4 + 1], a[r * 4 + 2], a[r * 4 + 3]);
     }
-    else {
-        inversaesc.z = 0.0;
+}
+
+LAB3_TARGET_AVX2 static void StoreLanes_AVX2(const __m256d b[16], double* m0, double* m1, double* m2, double* m3)
+{
+    for (int r = 0; r < 4; ++r) {
+        __m256d r0 = b[r * 4 + 0], r1 = b[r * 4 + 1], r2 = b[r * 4 + 2], r3 = b[r * 4 + 3];
+        Transpose4_AVX2(r0, r1, r2, r3);
+        _mm256_storeu_pd(m0 + r * 4, r0);
+        _mm256_storeu_pd(m1 + r * 4, r1);
+        _mm256_storeu_pd(m2 + r * 4, r2);
+        _mm256_storeu_pd(m3 + r * 4, r3);
     }
+}
 
-    Matrix3x3 inversarot = R.Transposed();
+// Mateixes formules que Adjugate4x4 amb un carril per matriu. Retorna la
+// mascara (bits 0..3) de les matrius singulars, que queden a zero.
+LAB3_TARGET_AVX2 static int Inverse4_AVX2(const double* m0, const double* m1, const double* m2,
+                                          const double* m3, double* o0, double* o1, double* o2, double* o3)
+{
+#define MUL _mm256_mul_pd
+#define ADD _mm256_add_pd
+#define SUB _mm256_sub_pd
+    __m256d a[16], b[16];
+    LoadLanes_AVX2(m0, m1, m2, m3, a);
 
-    Matrix3x3 inversaRS;
-    for (int i = 0; i < 3; ++i) {
-        inversaRS.At(0, i) = inversarot.At(0, i) * inversaesc.x;
-        inversaRS.At(1, i) = inversarot.At(1, i) * inversaesc.y;
-        inversaRS.At(2, i) = inversarot.At(2, i) * inversaesc.z;
+    const __m256d s0 = SUB(MUL(a[0], a[5]), MUL(a[4], a[1]));
+    const __m256d s1 = SUB(MUL(a[0], a[6]), MUL(a[4], a[2]));
+    const __m256d s2 = SUB(MUL(a[0], a[7]), MUL(a[4], a[3]));
+    const __m256d s3 = SUB(MUL(a[1], a[6]), MUL(a[5], a[2]));
+    const __m256d s4 = SUB(MUL(a[1], a[7]), MUL(a[5], a[3]));
+    const __m256d s5 = SUB(MUL(a[2], a[7]), MUL(a[6], a[3]));
+
+    const __m256d c5 = SUB(MUL(a[10], a[15]), MUL(a[14], a[11]));
+    const __m256d c4 = SUB(MUL(a[9], a[15]), MUL(a[13], a[11]));
+    const __m256d c3 = SUB(MUL(a[9], a[14]), MUL(a[13], a[10]));
+    const __m256d c2 = SUB(MUL(a[8], a[15]), MUL(a[12], a[11]));
+    const __m256d c1 = SUB(MUL(a[8], a[14]), MUL(a[12], a[10]));
+    const __m256d c0 = SUB(MUL(a[8], a[13]), MUL(a[12], a[9]));
+
+    // x*p - y*q + z*r i la versio negada
+#define POS(x, p, y, q, z, r) ADD(SUB(MUL(x, p), MUL(y, q)), MUL(z, r))
+#define NEG(x, p, y, q, z, r) SUB(SUB(MUL(y, q), MUL(x, p)), MUL(z, r))
+
+    b[0] = POS(a[5], c5, a[6], c4, a[7], c3);
+    b[1] = NEG(a[1], c5, a[2], c4, a[3], c3);
+    b[2] = POS(a[13], s5, a[14], s4, a[15], s3);
+    b[3] = NEG(a[9], s5, a[10], s4, a[11], s3);
+
+    b[4] = NEG(a[4], c5, a[6], c2, a[7], c1);
+    b[5] = POS(a[0], c5, a[2], c2, a[3], c1);
+    b[6] = NEG(a[12], s5, a[14], s2, a[15], s1);
+    b[7] = POS(a[8], s5, a[10], s2, a[11], s1);
+
+    b[8] = POS(a[4], c4, a[5], c2, a[7], c0);
+    b[9] = NEG(a[0], c4, a[1], c2, a[3], c0);
+    b[10] = POS(a[12], s4, a[13], s2, a[15], s0);
+    b[11] = NEG(a[8], s4, a[9], s2, a[11], s0);
+
+    b[12] = NEG(a[4], c3, a[5], c1, a[6], c0);
+    b[13] = POS(a[0], c3, a[1], c1, a[2], c0);
+    b[14] = NEG(a[12], s3, a[13], s1, a[14], s0);
+    b[15] = POS(a[8], s3, a[9], s1, a[10], s0);
+
+    const __m256d det = ADD(ADD(SUB(ADD(SUB(MUL(s0, c5), MUL(s1, c4)), MUL(s2, c3)), MUL(s4, c1)), MUL(s3, c2)), MUL(s5, c0));
+
+    // Cota de Hadamard, com IsSingular4x4
+    __m256d bound2 = _mm256_set1_pd(1.0);
+    for (int r = 0; r < 4; ++r) {
+        __m256d n2 = MUL(a[r * 4 + 0], a[r * 4 + 0]);
+        n2 = ADD(n2, MUL(a[r * 4 + 1], a[r * 4 + 1]));
+        n2 = ADD(n2, MUL(a[r * 4 + 2], a[r * 4 + 2]));
+        n2 = ADD(n2, MUL(a[r * 4 + 3], a[r * 4 + 3]));
+        bound2 = MUL(bound2, n2);
+    }
+    const double rel = 64.0 * std::numeric_limits<double>::epsilon();
+    const __m256d ok = _mm256_cmp_pd(MUL(det, det), MUL(_mm256_set1_pd(rel * rel), bound2), _CMP_GT_OQ);
+    const __m256d inv = _mm256_and_pd(ok, _mm256_div_pd(_mm256_set1_pd(1.0), det));
+    for (int k = 0; k < 16; ++k) {
+        b[k] = MUL(b[k], inv);
+    }
+    StoreLanes_AVX2(b, o0, o1, o2, o3);
+    return (~_mm256_movemask_pd(ok)) & 0xF;
+#undef POS
+#undef NEG
+#undef MUL
+#undef ADD
+#undef SUB
+}
+
+#endif
+
+template <typename T>
+MathError Matrix4x4T<T>::InverseMany(std::span<const Matrix4x4T> in, std::span<Matrix4x4T> out)
+{
+    CheckBatchSize(in.size(), out.size());
+    bool singular = false;
+    std::size_t i = 0;
+
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            for (; i + 4 <= in.size(); i += 4) {
+                // Copia local: in i out poden ser el mateix buffer
+                Matrix4x4T r[4];
+                int mask = Inverse4_AVX2(in[i].m, in[i + 1].m, in[i + 2].m, in[i + 3].m,
+                                         r[0].m, r[1].m, r[2].m, r[3].m);
+                for (int k = 0; k < 4; ++k) out[i + k] = r[k];
+                if (mask) singular = true;
+            }
+        }
+    }
+#endif
+
+    for (; i < in.size(); ++i) {
+        Expected<Matrix4x4T> M = in[i].TryInverse();
+        if (!M) singular = true;
+        out[i] = M ? *M : Matrix4x4T();
     }
+    return singular ? MathError::Singular : MathError::None;
+}
 
-    Vec3 invTrans = inversaRS.Multiply(t);
-    invTrans.x = -invTrans.x;
-    invTrans.y = -invTrans.y;
-    invTrans.z = -invTrans.z;
+// --------------------------------------------------------------------------
+// Getters i setters sense validacio. Els checked comproven IsAffine() un sol
+// cop i criden aquests; els Try* retornen l'error en lloc de llancar.
+// --------------------------------------------------------------------------
+
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::GetTranslationUnchecked() const
+{
+    return { At(0, 3), At(1, 3), At(2, 3) };
+}
 
+template <typename T>
+Matrix3x3T<T> Matrix4x4T<T>::GetRotationScaleUnchecked() const
+{
+    Matrix3x3T<T> M;
     for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
-            M.At(i, j) = inversaRS.At(i, j);
+            M.At(i, j) = At(i, j);
         }
     }
+    return M;
+}
+
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::GetScaleUnchecked() const
+{
+    Vec3T<T> X(At(0, 0), At(1, 0), At(2, 0));
+    Vec3T<T> Y(At(0, 1), At(1, 1), At(2, 1));
+    Vec3T<T> Z(At(0, 2), At(1, 2), At(2, 2));
+    return { X.Norm(), Y.Norm(), Z.Norm() };
+}
 
-    M.At(0, 3) = invTrans.x;
-    M.At(1, 3) = invTrans.y;
-    M.At(2, 3) = invTrans.z;
-    M.At(3, 3) = 1.0;
+template <typename T>
+Matrix3x3T<T> Matrix4x4T<T>::GetRotationUnchecked() const
+{
+    Matrix3x3T<T> M;
+    Vec3T<T> s = GetScaleUnchecked();
+    const T escala[3] = { s.x, s.y, s.z };
 
+    // Columnes amb escala ~0 es deixen a zero
+    for (int j = 0; j < 3; ++j) {
+        if (std::abs(escala[j]) > Tol<T>()) {
+            for (int i = 0; i < 3; ++i) {
+                M.At(i, j) = At(i, j) / escala[j];
+            }
+        }
+    }
     return M;
 }
 
-Vec3 Matrix4x4::GetTranslation() const
+template <typename T>
+QuatT<T> Matrix4x4T<T>::GetRotationQuatUnchecked() const
 {
-    if (!IsAffine()) {
-        throw std::runtime_error("La matriu no s af");
+    return QuatT<T>::FromMatrix3x3Unchecked(GetRotationUnchecked());
+}
+
+template <typename T>
+void Matrix4x4T<T>::SetTranslationUnchecked(const Vec3T<T>& t)
+{
+    At(0, 3) = t.x;
+    At(1, 3) = t.y;
+    At(2, 3) = t.z;
+}
+
+template <typename T>
+void Matrix4x4T<T>::SetScaleUnchecked(const Vec3T<T>& s)
+{
+    Matrix3x3T<T> M = GetRotationUnchecked();
+    const T escala[3] = { s.x, s.y, s.z };
+
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) {
+            At(i, j) = M.At(i, j) * escala[j];
+        }
     }
-    Vec3 result;
-    result = { At(0, 3), At(1, 3), At(2, 3) };
-    return result;
 }
 
-Matrix3x3 Matrix4x4::GetRotationScale() const
+template <typename T>
+void Matrix4x4T<T>::SetRotationUnchecked(const Matrix3x3T<T>& R)
 {
-    if (!IsAffine()) {
-        throw std::runtime_error("La matriu no s af");
+    Vec3T<T> s = GetScaleUnchecked();
+    const T escala[3] = { s.x, s.y, s.z };
+
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) {
+            At(i, j) = R.At(i, j) * escala[j];
+        }
     }
-    Matrix3x3 M;
+}
+
+template <typename T>
+void Matrix4x4T<T>::SetRotationUnchecked(const QuatT<T>& q)
+{
+    SetRotationUnchecked(q.ToMatrix3x3());
+}
+
+template <typename T>
+void Matrix4x4T<T>::SetRotationScaleUnchecked(const Matrix3x3T<T>& RS)
+{
     for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
-            M.At(i, j) = At(i, j);
+            At(i, j) = RS.At(i, j);
         }
     }
-    return M;
 }
 
-Vec3 Matrix4x4::GetScale() const
+// ---------------------------- Checked -------------------------------------
+
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::GetTranslation() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Vec3 X(At(0, 0), At(1, 0), At(2, 0));
-    Vec3 Y(At(0, 1), At(1, 1), At(2, 1));
-    Vec3 Z(At(0, 2), At(1, 2), At(2, 2));
-    Vec3 result(X.Norm(), Y.Norm(), Z.Norm());
-	return result;
+    return GetTranslationUnchecked();
 }
 
-Matrix3x3 Matrix4x4::GetRotation() const
+template <typename T>
+Matrix3x3T<T> Matrix4x4T<T>::GetRotationScale() const
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
-    Vec3 s = GetScale();
+    return GetRotationScaleUnchecked();
+}
 
-    if (std::abs(s.x) > TOL) {
-        M.At(0, 0) = At(0, 0) / s.x;
-        M.At(1, 0) = At(1, 0) / s.x;
-        M.At(2, 0) = At(2, 0) / s.x;
+template <typename T>
+Vec3T<T> Matrix4x4T<T>::GetScale() const
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
     }
+    return GetScaleUnchecked();
+}
 
-    if (std::abs(s.y) > TOL) {
-        M.At(0, 1) = At(0, 1) / s.y;
-        M.At(1, 1) = At(1, 1) / s.y;
-        M.At(2, 1) = At(2, 1) / s.y;
+template <typename T>
+Matrix3x3T<T> Matrix4x4T<T>::GetRotation() const
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
     }
+    return GetRotationUnchecked();
+}
 
-    if (std::abs(s.z) > TOL) {
-        M.At(0, 2) = At(0, 2) / s.z;
-        M.At(1, 2) = At(1, 2) / s.z;
-        M.At(2, 2) = At(2, 2) / s.z;
+template <typename T>
+QuatT<T> Matrix4x4T<T>::GetRotationQuat() const
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
     }
-    return M;
+    // FromMatrix3x3 fa l'unica comprovacio de rotacio
+    return QuatT<T>::FromMatrix3x3(GetRotationUnchecked());
 }
 
-Quat Matrix4x4::GetRotationQuat() const
+template <typename T>
+void Matrix4x4T<T>::SetTranslation(const Vec3T<T>& t)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
-    Quat R;
-    M = GetRotation();
-    R = Quat::FromMatrix3x3(M);
-	return R;
+    SetTranslationUnchecked(t);
 }
 
-void Matrix4x4::SetTranslation(const Vec3& t)
+template <typename T>
+void Matrix4x4T<T>::SetScale(const Vec3T<T>& s)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    At(0, 3) = t.x;
-    At(1, 3) = t.y;
-    At(2, 3) = t.z;
+    SetScaleUnchecked(s);
 }
 
-void Matrix4x4::SetScale(const Vec3& s)
+template <typename T>
+void Matrix4x4T<T>::SetRotation(const Matrix3x3T<T>& R)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Matrix3x3 M;
-    M = GetRotation();
-
-    double escala[3] = { s.x, s.y, s.z };
+    SetRotationUnchecked(R);
+}
 
-    for (int j = 0; j < 3; ++j) {
-        for (int i = 0; i < 3; ++i) {
-            At(i, j) = M.At(i, j) * escala[j];
-        }
+template <typename T>
+void Matrix4x4T<T>::SetRotation(const QuatT<T>& q)
+{
+    if (!IsAffine()) {
+        throw std::runtime_error("La matriu no s af");
     }
+    SetRotationUnchecked(q);
 }
 
-void Matrix4x4::SetRotation(const Matrix3x3& R)
+template <typename T>
+void Matrix4x4T<T>::SetRotationScale(const Matrix3x3T<T>& RS)
 {
     if (!IsAffine()) {
         throw std::runtime_error("La matriu no s af");
     }
-    Vec3 s = GetScale();
-    double escala[3] = { s.x, s.y, s.z };
+    SetRotationScaleUnchecked(RS);
+}
+
+// ------------------------------ Try ---------------------------------------
 
+template <typename T>
+Expected<Vec3T<T>> Matrix4x4T<T>::TryGetTranslation() const
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    return GetTranslationUnchecked();
+}
+
+template <typename T>
+Expected<Matrix3x3T<T>> Matrix4x4T<T>::TryGetRotationScale() const
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    return GetRotationScaleUnchecked();
+}
+
+template <typename T>
+Expected<Vec3T<T>> Matrix4x4T<T>::TryGetScale() const
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    return GetScaleUnchecked();
+}
+
+template <typename T>
+Expected<Matrix3x3T<T>> Matrix4x4T<T>::TryGetRotation() const
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    return GetRotationUnchecked();
+}
+
+template <typename T>
+Expected<QuatT<T>> Matrix4x4T<T>::TryGetRotationQuat() const
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    Matrix3x3T<T> R = GetRotationUnchecked();
+    if (!R.IsRotation()) return MathError::NotRotation;
+    return QuatT<T>::FromMatrix3x3Unchecked(R).Normalized();
+}
+
+template <typename T>
+MathError Matrix4x4T<T>::TrySetTranslation(const Vec3T<T>& t)
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    SetTranslationUnchecked(t);
+    return MathError::None;
+}
+
+template <typename T>
+MathError Matrix4x4T<T>::TrySetScale(const Vec3T<T>& s)
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    SetScaleUnchecked(s);
+    return MathError::None;
+}
+
+template <typename T>
+MathError Matrix4x4T<T>::TrySetRotation(const Matrix3x3T<T>& R)
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    SetRotationUnchecked(R);
+    return MathError::None;
+}
+
+template <typename T>
+MathError Matrix4x4T<T>::TrySetRotation(const QuatT<T>& q)
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    if (q.s == 0 && q.x == 0 && q.y == 0 && q.z == 0) return MathError::ZeroNorm;
+    SetRotationUnchecked(q);
+    return MathError::None;
+}
+
+template <typename T>
+MathError Matrix4x4T<T>::TrySetRotationScale(const Matrix3x3T<T>& RS)
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    SetRotationScaleUnchecked(RS);
+    return MathError::None;
+}
+
+// --------------------------------------------------------------------------
+// Descomposicio TRS
+// --------------------------------------------------------------------------
+
+// Retorna false si alguna escala es ~0: la columna queda a zero, R no es una
+// rotacio i q no te sentit. Amb det < 0 (mirall) es nega l'escala x i la
+// seva columna, de manera que R es una rotacio i FromTRS(t, q, s) == M.
+template <typename T>
+MathError Matrix4x4T<T>::CheckDecompose() const
+{
+    if (!IsAffine()) return MathError::NotAffine;
+    // Una columna amb escala ~0 no te direccio: la rotacio no queda definida
     for (int j = 0; j < 3; ++j) {
-        for (int i = 0; i < 3; ++i) {
-            At(i, j) = R.At(i, j) * escala[j];
-        }
+        const T n2 = At(0, j) * At(0, j) + At(1, j) * At(1, j) + At(2, j) * At(2, j);
+        if (!(n2 > Tol<T>() * Tol<T>())) return MathError::Singular;
     }
-    
+    return MathError::None;
 }
 
-void Matrix4x4::SetRotation(const Quat& q)
+template <typename T>
+static void DecomposeTRS(const Matrix4x4T<T>& M, Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s)
 {
-    if (!IsAffine()) {
-        throw std::runtime_error("La matriu no s af");
+    T escala[3];
+    Matrix3x3T<T> R;
+    for (int j = 0; j < 3; ++j) {
+        const T c0 = M.At(0, j), c1 = M.At(1, j), c2 = M.At(2, j);
+        escala[j] = std::sqrt(c0 * c0 + c1 * c1 + c2 * c2);
+        // Mateix criteri que GetRotation: columnes amb escala ~0 queden a zero
+        const T inv = (escala[j] > Tol<T>()) ? T(1) / escala[j] : T(0);
+        R.At(0, j) = c0 * inv;
+        R.At(1, j) = c1 * inv;
+        R.At(2, j) = c2 * inv;
+    }
+    if (R.Det() < 0) {
+        escala[0] = -escala[0];
+        R.At(0, 0) = -R.At(0, 0);
+        R.At(1, 0) = -R.At(1, 0);
+        R.At(2, 0) = -R.At(2, 0);
     }
-    SetRotation(q.ToMatrix3x3());
+    t = { M.At(0, 3), M.At(1, 3), M.At(2, 3) };
+    s = { escala[0], escala[1], escala[2] };
+    q = QuatT<T>::FromMatrix3x3Unchecked(R);
 }
 
-void Matrix4x4::SetRotationScale(const Matrix3x3& RS)
+// Llanca amb el missatge de cada error de CheckDecompose
+static void ThrowDecompose(MathError e)
 {
-    if (!IsAffine()) {
+    if (e == MathError::NotAffine) {
         throw std::runtime_error("La matriu no s af");
     }
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            At(i, j) = RS.At(i, j);
-        }
+    if (e == MathError::Singular) {
+        throw std::runtime_error("La matriu s singular");
     }
-}
\ No newline at end of file
+}
+
+template <typename T>
+void Matrix4x4T<T>::DecomposeUnchecked(Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s) const
+{
+    DecomposeTRS(*this, t, q, s);
+}
+
+template <typename T>
+void Matrix4x4T<T>::Decompose(Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s) const
+{
+    ThrowDecompose(CheckDecompose());
+    DecomposeTRS(*this, t, q, s);
+}
+
+template <typename T>
+MathError Matrix4x4T<T>::TryDecompose(Vec3T<T>& t, QuatT<T>& q, Vec3T<T>& s) const
+{
+    const MathError e = CheckDecompose();
+    if (e != MathError::None) return e;
+    DecomposeTRS(*this, t, q, s);
+    return MathError::None;
+}
+
+template <typename T>
+void Matrix4x4T<T>::DecomposeMany(std::span<const Matrix4x4T> M, std::span<Vec3T<T>> t,
+                                  std::span<QuatT<T>> q, std::span<Vec3T<T>> s)
+{
+    CheckBatchSize(M.size(), t.size());
+    CheckBatchSize(M.size(), q.size());
+    CheckBatchSize(M.size(), s.size());
+    for (const Matrix4x4T& A : M) {
+        ThrowDecompose(A.CheckDecompose());
+    }
+    for (std::size_t i = 0; i < M.size(); ++i) {
+        DecomposeTRS(M[i], t[i], q[i], s[i]);
+    }
+}
+
+template struct Matrix4x4T<float>;
+template struct Matrix4x4T<double>;
@@ -0,0 +1,84 @@
+#include "ParallelTransform.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+static void CheckSizes(std::size_t n, std::initializer_list<std::size_t> others)
+{
+    for (std::size_t m : others) {
+        if (m != n) {
+            throw std::invalid_argument("Transformacio en lot amb fils: mides d'entrada i sortida diferents");
+        }
+    }
+}
+
+// Elements per tros perque entrada + sortida ocupin ~128 KiB (multiple de 8
+// per no partir els blocs dels kernels SIMD)
+static std::size_t CacheGrain(std::size_t grain, std::size_t bytesPerItem)
+{
+    if (grain != 0) {
+        return grain;
+    }
+    return std::max<std::size_t>(8, (128 * 1024 / bytesPerItem) & ~std::size_t(7));
+}
+
+template <typename T>
+void TransformPointsParallel(const Matrix4x4T<T>& M, std::span<const Vec3T<NonDeduced<T>>> in, std::span<Vec3T<NonDeduced<T>>> out,
+                             ThreadPool& pool, std::size_t grain)
+{
+    CheckSizes(in.size(), { out.size() });
+    pool.ParallelFor(in.size(), CacheGrain(grain, 2 * sizeof(Vec3T<T>)), [&](std::size_t b, std::size_t e) {
+        M.TransformPoints(in.subspan(b, e - b), out.subspan(b, e - b));
+    });
+}
+
+template <typename T>
+void TransformVectorsParallel(const Matrix4x4T<T>& M, std::span<const Vec3T<NonDeduced<T>>> in, std::span<Vec3T<NonDeduced<T>>> out,
+                              ThreadPool& pool, std::size_t grain)
+{
+    CheckSizes(in.size(), { out.size() });
+    pool.ParallelFor(in.size(), CacheGrain(grain, 2 * sizeof(Vec3T<T>)), [&](std::size_t b, std::size_t e) {
+        M.TransformVectors(in.subspan(b, e - b), out.subspan(b, e - b));
+    });
+}
+
+template <typename T>
+void TransformPointsParallel(const Matrix4x4T<T>& M, std::span<const NonDeduced<T>> x, std::span<const NonDeduced<T>> y, std::span<const NonDeduced<T>> z,
+                             std::span<NonDeduced<T>> ox, std::span<NonDeduced<T>> oy, std::span<NonDeduced<T>> oz,
+                             ThreadPool& pool, std::size_t grain)
+{
+    CheckSizes(x.size(), { y.size(), z.size(), ox.size(), oy.size(), oz.size() });
+    pool.ParallelFor(x.size(), CacheGrain(grain, 6 * sizeof(T)), [&](std::size_t b, std::size_t e) {
+        const std::size_t n = e - b;
+        M.TransformPoints(x.subspan(b, n), y.subspan(b, n), z.subspan(b, n),
+                          ox.subspan(b, n), oy.subspan(b, n), oz.subspan(b, n));
+    });
+}
+
+template <typename T>
+void TransformVectorsParallel(const Matrix4x4T<T>& M, std::span<const NonDeduced<T>> x, std::span<const NonDeduced<T>> y, std::span<const NonDeduced<T>> z,
+                              std::span<NonDeduced<T>> ox, std::span<NonDeduced<T>> oy, std::span<NonDeduced<T>> oz,
+                              ThreadPool& pool, std::size_t grain)
+{
+    CheckSizes(x.size(), { y.size(), z.size(), ox.size(), oy.size(), oz.size() });
+    pool.ParallelFor(x.size(), CacheGrain(grain, 6 * sizeof(T)), [&](std::size_t b, std::size_t e) {
+        const std::size_t n = e - b;
+        M.TransformVectors(x.subspan(b, n), y.subspan(b, n), z.subspan(b, n),
+                           ox.subspan(b, n), oy.subspan(b, n), oz.subspan(b, n));
+    });
+}
+
+#define LAB3_INSTANTIATE(T)                                                                                  \
+    template void TransformPointsParallel<T>(const Matrix4x4T<T>&, std::span<const Vec3T<T>>,               \
+                                             std::span<Vec3T<T>>, ThreadPool&, std::size_t);                \
+    template void TransformVectorsParallel<T>(const Matrix4x4T<T>&, std::span<const Vec3T<T>>,              \
+                                              std::span<Vec3T<T>>, ThreadPool&, std::size_t);               \
+    template void TransformPointsParallel<T>(const Matrix4x4T<T>&, std::span<const T>, std::span<const T>,  \
+                                             std::span<const T>, std::span<T>, std::span<T>, std::span<T>,  \
+                                             ThreadPool&, std::size_t);                                     \
+    template void TransformVectorsParallel<T>(const Matrix4x4T<T>&, std::span<const T>, std::span<const T>, \
+                                              std::span<const T>, std::span<T>, std::span<T>, std::span<T>, \
+                                              ThreadPool&, std::size_t);
+
+LAB3_INSTANTIATE(float)
+LAB3_INSTANTIATE(double)
+#undef LAB3_INSTANTIATE
@@ -0,0 +1,513 @@
+#include "Quantize.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+static_assert(sizeof(PackedTransform32) == 16, "PackedTransform32 ha de ser de 16 bytes");
+static_assert(sizeof(PackedTransform48) == 18, "PackedTransform48 ha de ser de 18 bytes");
+
+// Bits per component del quaternio i paraules de 16 bits que ocupa
+template <typename P> struct PackTraits;
+template <> struct PackTraits<PackedTransform32> { static constexpr int Bits = 10; static constexpr int Words = 2; };
+template <> struct PackTraits<PackedTransform48> { static constexpr int Bits = 15; static constexpr int Words = 3; };
+
+template <typename P>
+static std::uint64_t GetQuatBits(const P& p)
+{
+    std::uint64_t v = 0;
+    for (int w = 0; w < PackTraits<P>::Words; ++w) v |= std::uint64_t(p.q[w]) << (16 * w);
+    return v;
+}
+
+template <typename P>
+static void SetQuatBits(P& p, std::uint64_t v)
+{
+    for (int w = 0; w < PackTraits<P>::Words; ++w) p.q[w] = static_cast<std::uint16_t>(v >> (16 * w));
+}
+
+// --------------------------------------------------------------------------
+// Smallest-three. Les tres components petites estan en [-1/sqrt2, 1/sqrt2] i
+// es quantitzen uniformement en B bits; la gran (>= 1/2) es reconstrueix
+// amb sqrt(1 - a^2 - b^2 - c^2). Les components es guarden en l'ordre
+// (s, x, y, z) saltant la gran: idx a bits [3B, 3B+2), a, b, c a [2B..), [B..), [0..).
+// --------------------------------------------------------------------------
+
+// Satura a [0, k] (NaN -> 0) i arrodoneix al parell mes proper, com el kernel
+// SIMD. La suma de 2^52 (2^23 en float) arrodoneix sense cridar nearbyint.
+template <typename T>
+static std::uint32_t RoundClamp(T v, T k)
+{
+    if (!(v >= 0)) v = 0;
+    if (v > k) v = k;
+    const T magic = std::is_same_v<T, float> ? T(8388608.0) : T(4503599627370496.0);
+    return static_cast<std::uint32_t>((v + magic) - magic);
+}
+
+template <int B, typename T>
+static std::uint64_t PackQuat(const QuatT<T>& q)
+{
+    const T c[4] = { q.s, q.x, q.y, q.z };
+    int big = 0;
+    T best = std::abs(c[0]);
+    for (int j = 1; j < 4; ++j) {
+        if (std::abs(c[j]) > best) { best = std::abs(c[j]); big = j; }
+    }
+    const T sign = (c[big] < 0) ? T(-1) : T(1);
+    const T k = T((1 << B) - 1);
+    const T scale = k * std::sqrt(T(0.5)), offset = k * T(0.5);
+    std::uint64_t v = static_cast<std::uint64_t>(big);
+    for (int j = 0; j < 4; ++j) {
+        if (j != big) v = (v << B) | RoundClamp(sign * c[j] * scale + offset, k);
+    }
+    return v;
+}
+
+template <int B, typename T>
+static QuatT<T> UnpackQuat(std::uint64_t v)
+{
+    constexpr std::uint64_t mask = (std::uint64_t(1) << B) - 1;
+    const T step = std::sqrt(T(2)) / T(mask), lo = -std::sqrt(T(0.5));
+    const T a = T((v >> (2 * B)) & mask) * step + lo;
+    const T b = T((v >> B) & mask) * step + lo;
+    const T c = T(v & mask) * step + lo;
+    const int big = static_cast<int>((v >> (3 * B)) & 3);
+    const T L = std::sqrt(std::max(T(0), T(1) - (a * a + b * b + c * c)));
+    T r[4];
+    int k = 0;
+    const T small[3] = { a, b, c };
+    for (int j = 0; j < 4; ++j) r[j] = (j == big) ? L : small[k++];
+    const T inv = T(1) / std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+    return { r[0] * inv, r[1] * inv, r[2] * inv, r[3] * inv };
+}
+
+// --------------------------------------------------------------------------
+// Half float (binary16). Codificacio de float amb arrodoniment al parell
+// (F. Giesen); de double es passa abans per float, que no introdueix doble
+// arrodoniment perque 24 >= 2 * 11 + 2.
+// --------------------------------------------------------------------------
+
+static std::uint16_t FloatToHalf(float f)
+{
+    const std::uint32_t x = std::bit_cast<std::uint32_t>(f);
+    const std::uint32_t sign = (x >> 16) & 0x8000u;
+    std::uint32_t a = x & 0x7fffffffu;
+    std::uint32_t o;
+    if (a >= (127u + 16u) << 23) {
+        // Overflow -> inf; NaN es queda com a NaN silencios
+        o = (a > 0x7f800000u) ? 0x7e00u : 0x7c00u;
+    } else if (a < 113u << 23) {
+        // Subnormal: la suma amb 0.5 alinea la mantissa i arrodoneix
+        const float magic = std::bit_cast<float>(126u << 23);
+        o = std::bit_cast<std::uint32_t>(std::bit_cast<float>(a) + magic) - (126u << 23);
+    } else {
+        const std::uint32_t odd = (a >> 13) & 1u;
+        a += (std::uint32_t(15 - 127) << 23) + 0xfffu + odd;
+        o = a >> 13;
+    }
+    return static_cast<std::uint16_t>(o | sign);
+}
+
+template <typename T>
+static T HalfToReal(std::uint16_t h)
+{
+    const int e = (h >> 10) & 0x1f;
+    const int m = h & 0x3ff;
+    T v;
+    if (e == 0) {
+        v = std::ldexp(T(m), -24);
+    } else if (e == 31) {
+        v = m ? std::numeric_limits<T>::quiet_NaN() : std::numeric_limits<T>::infinity();
+    } else {
+        v = std::ldexp(T(m + 1024), e - 25);
+    }
+    return (h & 0x8000) ? -v : v;
+}
+
+// --------------------------------------------------------------------------
+// Primitives
+// --------------------------------------------------------------------------
+
+template <typename T>
+std::uint32_t QuantizeT<T>::EncodeQuat32(const QuatT<T>& q)
+{
+    return static_cast<std::uint32_t>(PackQuat<10>(q));
+}
+
+template <typename T>
+QuatT<T> QuantizeT<T>::DecodeQuat32(std::uint32_t bits)
+{
+    return UnpackQuat<10, T>(bits);
+}
+
+template <typename T>
+std::uint64_t QuantizeT<T>::EncodeQuat48(const QuatT<T>& q)
+{
+    return PackQuat<15>(q);
+}
+
+template <typename T>
+QuatT<T> QuantizeT<T>::DecodeQuat48(std::uint64_t bits)
+{
+    return UnpackQuat<15, T>(bits);
+}
+
+template <typename T>
+std::uint16_t QuantizeT<T>::EncodeFixed16(T x, T lo, T hi)
+{
+    return static_cast<std::uint16_t>(RoundClamp((x - lo) * (T(65535) / (hi - lo)), T(65535)));
+}
+
+template <typename T>
+T QuantizeT<T>::DecodeFixed16(std::uint16_t u, T lo, T hi)
+{
+    return lo + T(u) * ((hi - lo) / T(65535));
+}
+
+template <typename T>
+std::uint16_t QuantizeT<T>::EncodeHalf(T x)
+{
+    return FloatToHalf(static_cast<float>(x));
+}
+
+template <typename T>
+T QuantizeT<T>::DecodeHalf(std::uint16_t h)
+{
+    return HalfToReal<T>(h);
+}
+
+// --------------------------------------------------------------------------
+// Registres complets
+// --------------------------------------------------------------------------
+
+template <typename T>
+static void CheckRange(const AABBT<T>& r)
+{
+    if (!(r.max.x > r.min.x) || !(r.max.y > r.min.y) || !(r.max.z > r.min.z)) {
+        throw std::invalid_argument("Quantize: rang de translacio buit");
+    }
+}
+
+template <typename T, typename P>
+static void EncodeTRS(const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s, const AABBT<T>& r, P& out)
+{
+    SetQuatBits(out, PackQuat<PackTraits<P>::Bits>(q));
+    out.t[0] = QuantizeT<T>::EncodeFixed16(t.x, r.min.x, r.max.x);
+    out.t[1] = QuantizeT<T>::EncodeFixed16(t.y, r.min.y, r.max.y);
+    out.t[2] = QuantizeT<T>::EncodeFixed16(t.z, r.min.z, r.max.z);
+    out.s[0] = FloatToHalf(static_cast<float>(s.x));
+    out.s[1] = FloatToHalf(static_cast<float>(s.y));
+    out.s[2] = FloatToHalf(static_cast<float>(s.z));
+}
+
+// Com FromTRS pero sense tornar a normalitzar q (UnpackQuat ja ho fa), amb
+// les mateixes operacions que el kernel SIMD
+template <typename T, typename P>
+static Matrix4x4T<T> DecodeRecord(const P& p, const AABBT<T>& r)
+{
+    const QuatT<T> q = UnpackQuat<PackTraits<P>::Bits, T>(GetQuatBits(p));
+    const T sc[3] = { HalfToReal<T>(p.s[0]), HalfToReal<T>(p.s[1]), HalfToReal<T>(p.s[2]) };
+    const T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const T sx = q.s * q.x, sy = q.s * q.y, sz = q.s * q.z;
+    const T R[9] = { T(1) - T(2) * (yy + zz), T(2) * (xy - sz), T(2) * (xz + sy),
+                     T(2) * (xy + sz), T(1) - T(2) * (xx + zz), T(2) * (yz - sx),
+                     T(2) * (xz - sy), T(2) * (yz + sx), T(1) - T(2) * (xx + yy) };
+    Matrix4x4T<T> M;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) M.At(i, j) = R[3 * i + j] * sc[j];
+    }
+    M.At(0, 3) = QuantizeT<T>::DecodeFixed16(p.t[0], r.min.x, r.max.x);
+    M.At(1, 3) = QuantizeT<T>::DecodeFixed16(p.t[1], r.min.y, r.max.y);
+    M.At(2, 3) = QuantizeT<T>::DecodeFixed16(p.t[2], r.min.z, r.max.z);
+    M.At(3, 3) = 1;
+    return M;
+}
+
+template <typename T>
+void QuantizeT<T>::Encode(const Matrix4x4T<T>& M, const AABBT<T>& range, PackedTransform32& out)
+{
+    CheckRange(range);
+    Vec3T<T> t, s;
+    QuatT<T> q;
+    M.Decompose(t, q, s);
+    EncodeTRS(t, q, s, range, out);
+}
+
+template <typename T>
+void QuantizeT<T>::Encode(const Matrix4x4T<T>& M, const AABBT<T>& range, PackedTransform48& out)
+{
+    CheckRange(range);
+    Vec3T<T> t, s;
+    QuatT<T> q;
+    M.Decompose(t, q, s);
+    EncodeTRS(t, q, s, range, out);
+}
+
+template <typename T>
+Matrix4x4T<T> QuantizeT<T>::Decode(const PackedTransform32& p, const AABBT<T>& range)
+{
+    CheckRange(range);
+    return DecodeRecord(p, range);
+}
+
+template <typename T>
+Matrix4x4T<T> QuantizeT<T>::Decode(const PackedTransform48& p, const AABBT<T>& range)
+{
+    CheckRange(range);
+    return DecodeRecord(p, range);
+}
+
+// --------------------------------------------------------------------------
+// Kernels en lot (double, AVX2 + F16C). Quatre registres per iteracio: la
+// part aritmetica es fa amb un carril per registre i nomes l'empaquetat de
+// bits es escalar. Mateixes operacions que les versions escalars.
+// --------------------------------------------------------------------------
+#if LAB3_SIMD_X86
+template <typename P>
+LAB3_TARGET_F16C static std::size_t EncodeTRS_AVX2(const Vec3T<double>* t, const QuatT<double>* q, const Vec3T<double>* s,
+                                                   const AABBT<double>& r, P* out, std::size_t n)
+{
+    constexpr int B = PackTraits<P>::Bits;
+    const double k = double((1 << B) - 1);
+    const __m256d vk = _mm256_set1_pd(k), scale = _mm256_set1_pd(k * std::sqrt(0.5)), offset = _mm256_set1_pd(k * 0.5);
+    const __m256d zero = _mm256_setzero_pd(), neg = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0), two = _mm256_set1_pd(2.0), three = _mm256_set1_pd(3.0);
+    const __m256i m3 = _mm256_set_epi64x(0, -1, -1, -1);
+    const __m256d tlo = _mm256_set_pd(0.0, r.min.z, r.min.y, r.min.x);
+    const __m256d tscale = _mm256_set_pd(0.0, 65535.0 / (r.max.z - r.min.z), 65535.0 / (r.max.y - r.min.y),
+                                         65535.0 / (r.max.x - r.min.x));
+    const __m256d tmax = _mm256_set1_pd(65535.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d S = _mm256_loadu_pd(&q[i].s), X = _mm256_loadu_pd(&q[i + 1].s);
+        __m256d Y = _mm256_loadu_pd(&q[i + 2].s), Z = _mm256_loadu_pd(&q[i + 3].s);
+        Transpose4_AVX2(S, X, Y, Z);
+
+        // Index de la component mes gran en valor absolut (la primera si empaten)
+        __m256d best = _mm256_andnot_pd(neg, S), idx = zero, big = S, m;
+#define PICK(V, I)                                                  \
+        m = _mm256_cmp_pd(_mm256_andnot_pd(neg, V), best, _CMP_GT_OQ); \
+        best = _mm256_blendv_pd(best, _mm256_andnot_pd(neg, V), m);    \
+        big = _mm256_blendv_pd(big, V, m);                             \
+        idx = _mm256_blendv_pd(idx, I, m);
+        PICK(X, one) PICK(Y, two) PICK(Z, three)
+#undef PICK
+        // Si la gran es negativa es codifica -q
+        const __m256d flip = _mm256_and_pd(_mm256_cmp_pd(big, zero, _CMP_LT_OQ), neg);
+        S = _mm256_xor_pd(S, flip); X = _mm256_xor_pd(X, flip);
+        Y = _mm256_xor_pd(Y, flip); Z = _mm256_xor_pd(Z, flip);
+        const __m256d e0 = _mm256_cmp_pd(idx, zero, _CMP_EQ_OQ);
+        const __m256d le1 = _mm256_cmp_pd(idx, one, _CMP_LE_OQ);
+        const __m256d e3 = _mm256_cmp_pd(idx, three, _CMP_EQ_OQ);
+        const __m256d a = _mm256_blendv_pd(S, X, e0);
+        const __m256d b = _mm256_blendv_pd(X, Y, le1);
+        const __m256d c = _mm256_blendv_pd(Z, Y, e3);
+#define QUANT(V) _mm256_cvtpd_epi32(_mm256_min_pd(_mm256_max_pd(_mm256_round_pd(                    \
+            _mm256_add_pd(_mm256_mul_pd(V, scale), offset), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), zero), vk))
+        alignas(16) std::int32_t ua[4], ub[4], uc[4], ui[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(ua), QUANT(a));
+        _mm_store_si128(reinterpret_cast<__m128i*>(ub), QUANT(b));
+        _mm_store_si128(reinterpret_cast<__m128i*>(uc), QUANT(c));
+        _mm_store_si128(reinterpret_cast<__m128i*>(ui), _mm256_cvtpd_epi32(idx));
+#undef QUANT
+
+        for (int l = 0; l < 4; ++l) {
+            P& o = out[i + l];
+            const std::uint64_t v = (std::uint64_t(ui[l]) << (3 * B)) | (std::uint64_t(ua[l]) << (2 * B))
+                | (std::uint64_t(ub[l]) << B) | std::uint64_t(uc[l]);
+            SetQuatBits(o, v);
+
+            // Translacio i escala: un carril per eix
+            const __m256d tv = _mm256_maskload_pd(&t[i + l].x, m3);
+            const __m256d tu = _mm256_min_pd(_mm256_max_pd(_mm256_round_pd(_mm256_mul_pd(_mm256_sub_pd(tv, tlo), tscale),
+                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), zero), tmax);
+            const __m128i t16 = _mm_packus_epi32(_mm256_cvtpd_epi32(tu), _mm_setzero_si128());
+            const __m128i s16 = _mm_cvtps_ph(_mm256_cvtpd_ps(_mm256_maskload_pd(&s[i + l].x, m3)),
+                                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            alignas(16) std::uint16_t tmp[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(tmp), t16);
+            _mm_store_si128(reinterpret_cast<__m128i*>(tmp + 8), s16);
+            std::memcpy(o.t, tmp, sizeof(o.t));
+            std::memcpy(o.s, tmp + 8, sizeof(o.s));
+        }
+    }
+    return i;
+}
+
+template <typename P>
+LAB3_TARGET_F16C static std::size_t DecodeRecords_AVX2(const P* in, const AABBT<double>& r, Matrix4x4T<double>* out, std::size_t n)
+{
+    constexpr int B = PackTraits<P>::Bits;
+    constexpr std::uint64_t mask = (std::uint64_t(1) << B) - 1;
+    const __m256d step = _mm256_set1_pd(std::sqrt(2.0) / double(mask)), lo = _mm256_set1_pd(-std::sqrt(0.5));
+    const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0), two = _mm256_set1_pd(2.0);
+    const __m256d tstep[3] = { _mm256_set1_pd((r.max.x - r.min.x) / 65535.0), _mm256_set1_pd((r.max.y - r.min.y) / 65535.0),
+                               _mm256_set1_pd((r.max.z - r.min.z) / 65535.0) };
+    const __m256d tlo[3] = { _mm256_set1_pd(r.min.x), _mm256_set1_pd(r.min.y), _mm256_set1_pd(r.min.z) };
+    const __m256d row3 = _mm256_set_pd(1.0, 0.0, 0.0, 0.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        alignas(16) std::int32_t ua[4], ub[4], uc[4], ui[4], ut[3][4];
+        alignas(16) std::uint16_t hs[3][8] = {};
+        for (int l = 0; l < 4; ++l) {
+            const P& p = in[i + l];
+            const std::uint64_t v = GetQuatBits(p);
+            ua[l] = static_cast<std::int32_t>((v >> (2 * B)) & mask);
+            ub[l] = static_cast<std::int32_t>((v >> B) & mask);
+            uc[l] = static_cast<std::int32_t>(v & mask);
+            ui[l] = static_cast<std::int32_t>((v >> (3 * B)) & 3);
+            for (int k = 0; k < 3; ++k) { ut[k][l] = p.t[k]; hs[k][l] = p.s[k]; }
+        }
+#define LOADI(a) _mm256_cvtepi32_pd(_mm_load_si128(reinterpret_cast<const __m128i*>(a)))
+        const __m256d a = _mm256_add_pd(_mm256_mul_pd(LOADI(ua), step), lo);
+        const __m256d b = _mm256_add_pd(_mm256_mul_pd(LOADI(ub), step), lo);
+        const __m256d c = _mm256_add_pd(_mm256_mul_pd(LOADI(uc), step), lo);
+        const __m256d idx = LOADI(ui);
+        const __m256d L = _mm256_sqrt_pd(_mm256_max_pd(_mm256_sub_pd(one,
+            _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(b, b)), _mm256_mul_pd(c, c))), zero));
+        const __m256d e0 = _mm256_cmp_pd(idx, zero, _CMP_EQ_OQ), e1 = _mm256_cmp_pd(idx, one, _CMP_EQ_OQ);
+        const __m256d e2 = _mm256_cmp_pd(idx, two, _CMP_EQ_OQ), le1 = _mm256_cmp_pd(idx, one, _CMP_LE_OQ);
+        const __m256d e3 = _mm256_cmp_pd(idx, _mm256_set1_pd(3.0), _CMP_EQ_OQ);
+        __m256d S = _mm256_blendv_pd(a, L, e0);
+        __m256d X = _mm256_blendv_pd(_mm256_blendv_pd(b, L, e1), a, e0);
+        __m256d Y = _mm256_blendv_pd(_mm256_blendv_pd(c, L, e2), b, le1);
+        __m256d Z = _mm256_blendv_pd(c, L, e3);
+        const __m256d inv = _mm256_div_pd(one, _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(S, S), _mm256_mul_pd(X, X)), _mm256_mul_pd(Y, Y)), _mm256_mul_pd(Z, Z))));
+        S = _mm256_mul_pd(S, inv); X = _mm256_mul_pd(X, inv); Y = _mm256_mul_pd(Y, inv); Z = _mm256_mul_pd(Z, inv);
+
+        __m256d sc[3], tr[3];
+        for (int k = 0; k < 3; ++k) {
+            sc[k] = _mm256_cvtps_pd(_mm_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(hs[k]))));
+            tr[k] = _mm256_add_pd(tlo[k], _mm256_mul_pd(LOADI(ut[k]), tstep[k]));
+        }
+#undef LOADI
+        const __m256d xx = _mm256_mul_pd(X, X), yy = _mm256_mul_pd(Y, Y), zz = _mm256_mul_pd(Z, Z);
+        const __m256d xy = _mm256_mul_pd(X, Y), xz = _mm256_mul_pd(X, Z), yz = _mm256_mul_pd(Y, Z);
+        const __m256d sx = _mm256_mul_pd(S, X), sy = _mm256_mul_pd(S, Y), sz = _mm256_mul_pd(S, Z);
+        // Fila k de les quatre matrius: (R_k0 sx, R_k1 sy, R_k2 sz, t_k), transposada a AoS
+        __m256d r0[4] = { _mm256_mul_pd(_mm256_sub_pd(one, _mm256_mul_pd(two, _mm256_add_pd(yy, zz))), sc[0]),
+                          _mm256_mul_pd(_mm256_mul_pd(two, _mm256_sub_pd(xy, sz)), sc[1]),
+                          _mm256_mul_pd(_mm256_mul_pd(two, _mm256_add_pd(xz, sy)), sc[2]), tr[0] };
+        __m256d r1[4] = { _mm256_mul_pd(_mm256_mul_pd(two, _mm256_add_pd(xy, sz)), sc[0]),
+                          _mm256_mul_pd(_mm256_sub_pd(one, _mm256_mul_pd(two, _mm256_add_pd(xx, zz))), sc[1]),
+                          _mm256_mul_pd(_mm256_mul_pd(two, _mm256_sub_pd(yz, sx)), sc[2]), tr[1] };
+        __m256d r2[4] = { _mm256_mul_pd(_mm256_mul_pd(two, _mm256_sub_pd(xz, sy)), sc[0]),
+                          _mm256_mul_pd(_mm256_mul_pd(two, _mm256_add_pd(yz, sx)), sc[1]),
+                          _mm256_mul_pd(_mm256_sub_pd(one, _mm256_mul_pd(two, _mm256_add_pd(xx, yy))), sc[2]), tr[2] };
+        Transpose4_AVX2(r0[0], r0[1], r0[2], r0[3]);
+        Transpose4_AVX2(r1[0], r1[1], r1[2], r1[3]);
+        Transpose4_AVX2(r2[0], r2[1], r2[2], r2[3]);
+        for (int l = 0; l < 4; ++l) {
+            double* m = out[i + l].m;
+            _mm256_storeu_pd(m, r0[l]);
+            _mm256_storeu_pd(m + 4, r1[l]);
+            _mm256_storeu_pd(m + 8, r2[l]);
+            _mm256_storeu_pd(m + 12, row3);
+        }
+    }
+    return i;
+}
+#endif
+
+template <typename T>
+static bool UseKernels()
+{
+#if LAB3_SIMD_X86
+    return std::is_same_v<T, double> && GetSimdLevel() >= SimdLevel::AVX2 && HasF16C();
+#else
+    return false;
+#endif
+}
+
+template <typename T, typename P>
+static void EncodeManyImpl(std::span<const Matrix4x4T<T>> M, const AABBT<T>& range, std::span<P> out)
+{
+    if (M.size() != out.size()) {
+        throw std::invalid_argument("Quantize::EncodeMany: mides d'entrada i sortida diferents");
+    }
+    CheckRange(range);
+    // Mateixa validacio que Decompose; despres es descompon sense comprovar
+    for (const Matrix4x4T<T>& A : M) {
+        const MathError e = A.CheckDecompose();
+        if (e != MathError::None) {
+            throw std::runtime_error(std::string("Quantize::EncodeMany: ") + ToString(e));
+        }
+    }
+    // Per trossos: descomposicio a un buffer a la pila i codificacio del tros
+    constexpr std::size_t CHUNK = 64;
+    Vec3T<T> t[CHUNK], s[CHUNK];
+    QuatT<T> q[CHUNK];
+    for (std::size_t b = 0; b < M.size(); b += CHUNK) {
+        const std::size_t n = std::min(CHUNK, M.size() - b);
+        for (std::size_t i = 0; i < n; ++i) {
+            M[b + i].DecomposeUnchecked(t[i], q[i], s[i]);
+        }
+        std::size_t i = 0;
+#if LAB3_SIMD_X86
+        if constexpr (std::is_same_v<T, double>) {
+            if (UseKernels<T>()) {
+                i = EncodeTRS_AVX2(t, q, s, range, &out[b], n);
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            EncodeTRS(t[i], q[i], s[i], range, out[b + i]);
+        }
+    }
+}
+
+template <typename T, typename P>
+static void DecodeManyImpl(std::span<const P> in, const AABBT<T>& range, std::span<Matrix4x4T<T>> out)
+{
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("Quantize::DecodeMany: mides d'entrada i sortida diferents");
+    }
+    CheckRange(range);
+    std::size_t i = 0;
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (UseKernels<T>()) {
+            i = DecodeRecords_AVX2(in.data(), range, out.data(), in.size());
+        }
+    }
+#endif
+    for (; i < in.size(); ++i) {
+        out[i] = DecodeRecord(in[i], range);
+    }
+}
+
+template <typename T>
+void QuantizeT<T>::EncodeMany(std::span<const Matrix4x4T<T>> M, const AABBT<T>& range, std::span<PackedTransform32> out)
+{
+    EncodeManyImpl(M, range, out);
+}
+
+template <typename T>
+void QuantizeT<T>::EncodeMany(std::span<const Matrix4x4T<T>> M, const AABBT<T>& range, std::span<PackedTransform48> out)
+{
+    EncodeManyImpl(M, range, out);
+}
+
+template <typename T>
+void QuantizeT<T>::DecodeMany(std::span<const PackedTransform32> in, const AABBT<T>& range, std::span<Matrix4x4T<T>> out)
+{
+    DecodeManyImpl(in, range, out);
+}
+
+template <typename T>
+void QuantizeT<T>::DecodeMany(std::span<const PackedTransform48> in, const AABBT<T>& range, std::span<Matrix4x4T<T>> out)
+{
+    DecodeManyImpl(in, range, out);
+}
+
+template struct QuantizeT<float>;
+template struct QuantizeT<double>;
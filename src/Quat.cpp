@@ -1,127 +1,218 @@
 #include "Quat.hpp"
+#include "Simd.hpp"
+#include <algorithm>
 #include <stdexcept>
 
-#define TOL 1e-6
 #define PI 3.14159265358979323846
 
-Quat Quat::FromAxisAngle(const Vec3& u_in, double phi)
+template <typename T>
+QuatT<T> QuatT<T>::FromAxisAngle(const Vec3T<T>& u_in, T phi)
 {
-    Vec3 u = u_in.Normalize();
-    double half = 0.5 * phi;
-    double c = std::cos(half);
-    double s = std::sin(half);
-    return Quat{ c, u.x * s, u.y * s, u.z * s };
+    Vec3T<T> u = u_in.Normalize();
+    T half = T(0.5) * phi;
+    T c = std::cos(half);
+    T s = std::sin(half);
+    return QuatT{ c, u.x * s, u.y * s, u.z * s };
 }
 
-Quat Quat::Normalized() const
+template <typename T>
+QuatT<T> QuatT<T>::Normalized() const
 {
-    double n2 = s * s + x * x + y * y + z * z;
-    double n = std::sqrt(n2);
+    T n2 = s * s + x * x + y * y + z * z;
+    T n = std::sqrt(n2);
     if (n == 0) throw std::invalid_argument("Quat::Normalized: zero norm");
     return { s / n, x / n, y / n, z / n };
 }
 
-Quat Quat::Multiply(const Quat& b) const
+// v' = v + s*t + qv x t, amb t = 2 (qv x v). Escrit component a component,
+// sense temporals, perque tambe el facin servir els bucles de RotateMany.
+template <typename T>
+static inline void RotateCross(const QuatT<T>& q, T vx, T vy, T vz, T& ox, T& oy, T& oz)
 {
-    const Quat& a = *this;
-    Quat q;
-    q.s = a.s * b.s - a.x * b.x - a.y * b.y - a.z * b.z;
-    q.x = a.s * b.x + a.x * b.s + a.y * b.z - a.z * b.y;
-    q.y = a.s * b.y - a.x * b.z + a.y * b.s + a.z * b.x;
-    q.z = a.s * b.z + a.x * b.y - a.y * b.x + a.z * b.s;
-    return q;
+    const T tx = T(2) * (q.y * vz - q.z * vy);
+    const T ty = T(2) * (q.z * vx - q.x * vz);
+    const T tz = T(2) * (q.x * vy - q.y * vx);
+    ox = vx + q.s * tx + (q.y * tz - q.z * ty);
+    oy = vy + q.s * ty + (q.z * tx - q.x * tz);
+    oz = vz + q.s * tz + (q.x * ty - q.y * tx);
 }
 
-Vec3 Quat::Rotate(const Vec3& v) const
+template <typename T>
+Vec3T<T> QuatT<T>::Rotate(const Vec3T<T>& v) const
 {
-    Vec3 qv{ x, y, z };
-    Vec3 t = Vec3::Cross(qv, v);
-    t.x *= 2.0; t.y *= 2.0; t.z *= 2.0;
-    Vec3 st{ s * t.x, s * t.y, s * t.z };
-    Vec3 cqt = Vec3::Cross(qv, t);
-    Vec3 w{ v.x + st.x + cqt.x, v.y + st.y + cqt.y, v.z + st.z + cqt.z };
+    Vec3T<T> w;
+    RotateCross(*this, v.x, v.y, v.z, w.x, w.y, w.z);
     return w;
 }
 
-Matrix3x3 Quat::ToMatrix3x3() const
+template <typename T>
+Matrix3x3T<T> QuatT<T>::ToMatrix3x3() const
 {
-    Quat q = this->Normalized();
-    const double ww = q.s, xx = q.x, yy = q.y, zz = q.z;
+    QuatT q = this->Normalized();
+    const T ww = q.s, xx = q.x, yy = q.y, zz = q.z;
 
-    Matrix3x3 R{};
-    const double xx2 = xx * xx, yy2 = yy * yy, zz2 = zz * zz;
-    const double xy2 = xx * yy, xz2 = xx * zz, yz2 = yy * zz;
-    const double sx2 = ww * xx, sy2 = ww * yy, sz2 = ww * zz;
+    Matrix3x3T<T> R{};
+    const T xx2 = xx * xx, yy2 = yy * yy, zz2 = zz * zz;
+    const T xy2 = xx * yy, xz2 = xx * zz, yz2 = yy * zz;
+    const T sx2 = ww * xx, sy2 = ww * yy, sz2 = ww * zz;
 
-    R.At(0, 0) = 1.0 - 2.0 * (yy2 + zz2);
-    R.At(0, 1) = 2.0 * (xy2 - sz2);
-    R.At(0, 2) = 2.0 * (xz2 + sy2);
+    R.At(0, 0) = T(1) - T(2) * (yy2 + zz2);
+    R.At(0, 1) = T(2) * (xy2 - sz2);
+    R.At(0, 2) = T(2) * (xz2 + sy2);
 
-    R.At(1, 0) = 2.0 * (xy2 + sz2);
-    R.At(1, 1) = 1.0 - 2.0 * (xx2 + zz2);
-    R.At(1, 2) = 2.0 * (yz2 - sx2);
+    R.At(1, 0) = T(2) * (xy2 + sz2);
+    R.At(1, 1) = T(1) - T(2) * (xx2 + zz2);
+    R.At(1, 2) = T(2) * (yz2 - sx2);
 
-    R.At(2, 0) = 2.0 * (xz2 - sy2);
-    R.At(2, 1) = 2.0 * (yz2 + sx2);
-    R.At(2, 2) = 1.0 - 2.0 * (xx2 + yy2);
+    R.At(2, 0) = T(2) * (xz2 - sy2);
+    R.At(2, 1) = T(2) * (yz2 + sx2);
+    R.At(2, 2) = T(1) - T(2) * (xx2 + yy2);
     return R;
 }
 
-Quat Quat::FromMatrix3x3(const Matrix3x3& R)
+template <typename T>
+QuatT<T> QuatT<T>::FromMatrix3x3(const Matrix3x3T<T>& R)
 {
     if (!R.IsRotation()) throw std::invalid_argument("FromMatrix3x3: input not rotation");
+    // IsRotation accepta R ortonormal dins Tol: es renormalitza per no
+    // propagar l'error (sobretot en float)
+    return FromMatrix3x3Unchecked(R).Normalized();
+}
 
-    Quat q;
-    double tr = R.At(0, 0) + R.At(1, 1) + R.At(2, 2);
+// Variant de Shepperd amb dues comparacions (M. Day, "Converting a Rotation
+// Matrix to a Quaternion"): es tria la component mes gran segons m22 i
+// m00 vs m11, i les altres tres surten de sumes i restes fora de la
+// diagonal. Una sola arrel i cap divisio per component. Per a una R
+// ortonormal |q| = 1 per construccio, aixi que no es renormalitza. El
+// resultat es canonic: s >= 0.
+template <typename T>
+QuatT<T> QuatT<T>::FromMatrix3x3Unchecked(const Matrix3x3T<T>& R)
+{
+    const T m00 = R.At(0, 0), m01 = R.At(0, 1), m02 = R.At(0, 2);
+    const T m10 = R.At(1, 0), m11 = R.At(1, 1), m12 = R.At(1, 2);
+    const T m20 = R.At(2, 0), m21 = R.At(2, 1), m22 = R.At(2, 2);
 
-    if (tr > 0.0)
-    {
-        double S = std::sqrt(tr + 1.0) * 2.0;
-        q.s = 0.25 * S;
-        q.x = (R.At(2, 1) - R.At(1, 2)) / S;
-        q.y = (R.At(0, 2) - R.At(2, 0)) / S;
-        q.z = (R.At(1, 0) - R.At(0, 1)) / S;
+    QuatT q;
+    T t;
+    if (m22 < 0) {
+        if (m00 > m11) {
+            t = T(1) + m00 - m11 - m22;
+            q = { m21 - m12, t, m01 + m10, m20 + m02 };
+        }
+        else {
+            t = T(1) - m00 + m11 - m22;
+            q = { m02 - m20, m01 + m10, t, m12 + m21 };
+        }
     }
-    else if (R.At(0, 0) > R.At(1, 1) && R.At(0, 0) > R.At(2, 2))
-    {
-        double S = std::sqrt(1.0 + R.At(0, 0) - R.At(1, 1) - R.At(2, 2)) * 2.0;
-        q.s = (R.At(2, 1) - R.At(1, 2)) / S;
-        q.x = 0.25 * S;
-        q.y = (R.At(0, 1) + R.At(1, 0)) / S;
-        q.z = (R.At(0, 2) + R.At(2, 0)) / S;
+    else {
+        if (m00 < -m11) {
+            t = T(1) - m00 - m11 + m22;
+            q = { m10 - m01, m20 + m02, m12 + m21, t };
+        }
+        else {
+            t = T(1) + m00 + m11 + m22;
+            q = { t, m21 - m12, m02 - m20, m10 - m01 };
+        }
     }
-    else if (R.At(1, 1) > R.At(2, 2))
-    {
-        double S = std::sqrt(1.0 - R.At(0, 0) + R.At(1, 1) - R.At(2, 2)) * 2.0;
-        q.s = (R.At(0, 2) - R.At(2, 0)) / S;
-        q.x = (R.At(0, 1) + R.At(1, 0)) / S;
-        q.y = 0.25 * S;
-        q.z = (R.At(1, 2) + R.At(2, 1)) / S;
-    }
-    else
-    {
-        double S = std::sqrt(1.0 - R.At(0, 0) - R.At(1, 1) + R.At(2, 2)) * 2.0;
-        q.s = (R.At(1, 0) - R.At(0, 1)) / S;
-        q.x = (R.At(0, 2) + R.At(2, 0)) / S;
-        q.y = (R.At(1, 2) + R.At(2, 1)) / S;
-        q.z = 0.25 * S;
+    const T k = std::copysign(T(0.5) / std::sqrt(t), q.s);
+    return { q.s * k, q.x * k, q.y * k, q.z * k };
+}
+
+#if LAB3_SIMD_X86
+// Quatre matrius per iteracio, un carril per matriu. Es calculen els quatre
+// candidats de Day i es trien amb blends (sense branques); despres es
+// transposa per tornar a quaternions contigus. Retorna quantes n'ha fet.
+LAB3_TARGET_AVX2 static std::size_t FromMatrix3x3Many_AVX2(const double* R, double* q, std::size_t n)
+{
+    const __m256d one = _mm256_set1_pd(1.0), half = _mm256_set1_pd(0.5);
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const double* r = R + 9 * i;
+        // Elements 0..3 i 4..7 de cada matriu amb carregues de 4 i una
+        // transposicio; l'element 8 s'insereix directament
+        __m256d m[9];
+        for (int k = 0; k < 8; k += 4) {
+            m[k] = _mm256_loadu_pd(r + k);
+            m[k + 1] = _mm256_loadu_pd(r + 9 + k);
+            m[k + 2] = _mm256_loadu_pd(r + 18 + k);
+            m[k + 3] = _mm256_loadu_pd(r + 27 + k);
+            Transpose4_AVX2(m[k], m[k + 1], m[k + 2], m[k + 3]);
+        }
+        m[8] = _mm256_setr_pd(r[8], r[17], r[26], r[35]);
+#define ADD _mm256_add_pd
+#define SUB _mm256_sub_pd
+        // Elements fora de la diagonal compartits pels quatre candidats
+        const __m256d a = SUB(m[7], m[5]), b = SUB(m[2], m[6]), c = SUB(m[3], m[1]);
+        const __m256d d = ADD(m[1], m[3]), e = ADD(m[6], m[2]), f = ADD(m[5], m[7]);
+        const __m256d tw = ADD(ADD(one, m[0]), ADD(m[4], m[8]));
+        const __m256d tx = SUB(SUB(ADD(one, m[0]), m[4]), m[8]);
+        const __m256d ty = SUB(ADD(SUB(one, m[0]), m[4]), m[8]);
+        const __m256d tz = ADD(SUB(SUB(one, m[0]), m[4]), m[8]);
+#undef ADD
+#undef SUB
+        const __m256d useLow = _mm256_cmp_pd(m[8], _mm256_setzero_pd(), _CMP_LT_OQ);
+        const __m256d useX = _mm256_cmp_pd(m[0], m[4], _CMP_GT_OQ);
+        const __m256d useZ = _mm256_cmp_pd(m[0], _mm256_xor_pd(m[4], signBit), _CMP_LT_OQ);
+        // Candidats: W = (tw, a, b, c), X = (a, tx, d, e), Y = (b, d, ty, f), Z = (c, e, f, tz)
+#define PICK(w, x, y, z) _mm256_blendv_pd(_mm256_blendv_pd(w, z, useZ), _mm256_blendv_pd(y, x, useX), useLow)
+        __m256d qs = PICK(tw, a, b, c);
+        __m256d qx = PICK(a, tx, d, e);
+        __m256d qy = PICK(b, d, ty, f);
+        __m256d qz = PICK(c, e, f, tz);
+        const __m256d t = PICK(tw, tx, ty, tz);
+#undef PICK
+
+        // k = copysign(0.5 / sqrt(t), s): el resultat queda amb s >= 0
+        __m256d k = _mm256_div_pd(half, _mm256_sqrt_pd(t));
+        k = _mm256_or_pd(k, _mm256_and_pd(qs, signBit));
+        qs = _mm256_mul_pd(qs, k); qx = _mm256_mul_pd(qx, k);
+        qy = _mm256_mul_pd(qy, k); qz = _mm256_mul_pd(qz, k);
+
+        Transpose4_AVX2(qs, qx, qy, qz);
+        double* o = q + 4 * i;
+        _mm256_storeu_pd(o, qs);
+        _mm256_storeu_pd(o + 4, qx);
+        _mm256_storeu_pd(o + 8, qy);
+        _mm256_storeu_pd(o + 12, qz);
     }
+    return i;
+}
+#endif
 
-    return q.Normalized();
+template <typename T>
+void QuatT<T>::FromMatrix3x3ManyUnchecked(std::span<const Matrix3x3T<T>> R, std::span<QuatT> out)
+{
+    if (R.size() != out.size()) {
+        throw std::invalid_argument("Quat::FromMatrix3x3ManyUnchecked: mides diferents");
+    }
+    std::size_t i = 0;
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            static_assert(sizeof(Matrix3x3T<double>) == 9 * sizeof(double), "Matrix3x3 ha de ser 9 doubles contigus");
+            i = FromMatrix3x3Many_AVX2(reinterpret_cast<const double*>(R.data()), reinterpret_cast<double*>(out.data()), R.size());
+        }
+    }
+#endif
+    for (; i < R.size(); ++i) {
+        out[i] = FromMatrix3x3Unchecked(R[i]);
+    }
 }
 
-void Quat::ToAxisAngle(Vec3& axis, double& angle) const
+template <typename T>
+void QuatT<T>::ToAxisAngle(Vec3T<T>& axis, T& angle) const
 {
-    Quat q = this->Normalized();
+    QuatT q = this->Normalized();
 
-    angle = 2.0 * std::acos(q.s);
+    angle = T(2) * std::acos(q.s);
 
-    double sin_half = std::sqrt(std::max(0.0, 1.0 - q.s * q.s));
+    T sin_half = std::sqrt(std::max(T(0), T(1) - q.s * q.s));
 
-    if (sin_half < TOL)
+    if (sin_half < Tol<T>())
     {
         axis = { 1, 0, 0 };
-        angle = 0.0;
+        angle = 0;
         return;
     }
 
@@ -129,47 +220,350 @@ void Quat::ToAxisAngle(Vec3& axis, double& angle) const
     axis = axis.Normalize();
 }
 
-Quat Quat::RotateFromTo(const Vec3& u, const Vec3& v)
+template <typename T>
+QuatT<T> QuatT<T>::RotateFromTo(const Vec3T<T>& u, const Vec3T<T>& v)
 {
-    Vec3 a{ u.Normalize()};
-    Vec3 b{ v.Normalize()};
+    Vec3T<T> a{ u.Normalize()};
+    Vec3T<T> b{ v.Normalize()};
 
-    double dot = Vec3::Dot(a, b);
+    T dot = Vec3T<T>::Dot(a, b);
 
-    if (std::fabs(dot - 1.0) < TOL) {
-        return Quat{}; // (1,0,0,0)
+    if (std::fabs(dot - T(1)) < Tol<T>()) {
+        return QuatT{}; // (1,0,0,0)
     }
 
-    if (std::fabs(dot + 1.0) < TOL) {
-        Vec3 arbitrary = (std::fabs(a.x) < 0.9) ? Vec3{ 1,0,0 } : Vec3{ 0,1,0 };
-        Vec3 axis = Vec3::Cross(a, arbitrary).Normalize();
-        return FromAxisAngle(axis, PI);
+    if (std::fabs(dot + T(1)) < Tol<T>()) {
+        Vec3T<T> arbitrary = (std::fabs(a.x) < T(0.9)) ? Vec3T<T>{ 1,0,0 } : Vec3T<T>{ 0,1,0 };
+        Vec3T<T> axis = Vec3T<T>::Cross(a, arbitrary).Normalize();
+        return FromAxisAngle(axis, T(PI));
     }
 
-    Vec3 axis = Vec3::Cross(a, b).Normalize();
-    double angle = std::acos(dot);
+    Vec3T<T> axis = Vec3T<T>::Cross(a, b).Normalize();
+    T angle = std::acos(dot);
     return FromAxisAngle(axis, angle);
 }
 
-Quat Quat::RotateToTarget(const Quat& initialRot, const Quat& finalRot)
+template <typename T>
+QuatT<T> QuatT<T>::RotateToTarget(const QuatT& initialRot, const QuatT& finalRot)
 {
-    Quat qi = initialRot.Normalized();
-    Quat qf = finalRot.Normalized();
+    QuatT qi = initialRot.Normalized();
+    QuatT qf = finalRot.Normalized();
 
-    Quat qi_conj{ qi.s, -qi.x, -qi.y, -qi.z };
+    QuatT qi_conj{ qi.s, -qi.x, -qi.y, -qi.z };
 
-    Quat qdelta = qf.Multiply(qi_conj);
+    QuatT qdelta = qf.Multiply(qi_conj);
     return qdelta.Normalized();
 }
 
-Quat Quat::FromEulerZYX(double yaw, double pitch, double roll)
+template <typename T>
+QuatT<T> QuatT<T>::FromEulerZYX(T yaw, T pitch, T roll)
 {
-    Matrix3x3 R = Matrix3x3::FromEulerZYX(yaw, pitch, roll);
+    Matrix3x3T<T> R = Matrix3x3T<T>::FromEulerZYX(yaw, pitch, roll);
     return FromMatrix3x3(R);
 }
 
-void Quat::ToEulerZYX(double& yaw, double& pitch, double& roll) const
+template <typename T>
+void QuatT<T>::ToEulerZYX(T& yaw, T& pitch, T& roll) const
 {
-    Matrix3x3 R = ToMatrix3x3();
+    Matrix3x3T<T> R = ToMatrix3x3();
     R.ToEulerZYX(yaw, pitch, roll);
-}
\ No newline at end of file
+}
+
+// ------------------ Interpolacio -----------------
+
+template <typename T>
+T QuatT<T>::Dot(const QuatT& a, const QuatT& b)
+{
+    return a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename T>
+QuatT<T> QuatT<T>::Nlerp(const QuatT& a, const QuatT& b, T t)
+{
+    // q i -q son la mateixa rotacio: s'agafa el cami curt
+    const T wa = T(1) - t;
+    const T wb = (Dot(a, b) < T(0)) ? -t : t;
+    QuatT q{ wa * a.s + wb * b.s, wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z };
+    return q.Normalized();
+}
+
+template <typename T>
+QuatT<T> QuatT<T>::Slerp(const QuatT& a, const QuatT& b, T t)
+{
+    T d = Dot(a, b);
+    T sign = T(1);
+    if (d < T(0)) {
+        d = -d;
+        sign = T(-1);
+    }
+    // Per angles molt petits sin(theta) ~ 0 i nlerp es equivalent
+    if (d > T(1) - Tol<T>()) {
+        return Nlerp(a, b, t);
+    }
+
+    const T theta = std::acos(d);
+    const T inv_sin = T(1) / std::sin(theta);
+    const T wa = std::sin((T(1) - t) * theta) * inv_sin;
+    const T wb = std::sin(t * theta) * inv_sin * sign;
+    return { wa * a.s + wb * b.s, wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z };
+}
+
+// Correccio de t perque nlerp segueixi la velocitat angular constant de slerp
+// (ajust polinomic en |dot| de Zeux Kapoulkine, "onlerp").
+template <typename T>
+static T SlerpFastT(T d, T t)
+{
+    const T A = T(1.0904) + d * (T(-3.2452) + d * (T(3.55645) - d * T(1.43519)));
+    const T B = T(0.848013) + d * (T(-1.06021) + d * T(0.215638));
+    const T k = A * (t - T(0.5)) * (t - T(0.5)) + B;
+    return t + t * (t - T(0.5)) * (t - T(1)) * k;
+}
+
+template <typename T>
+QuatT<T> QuatT<T>::SlerpFast(const QuatT& a, const QuatT& b, T t)
+{
+    return Nlerp(a, b, SlerpFastT(std::fabs(Dot(a, b)), t));
+}
+
+#if LAB3_SIMD_X86
+
+// Quatre quaternions per iteracio, un per carril. t_stride = 0 vol dir un
+// unic t per a tot el lot. Retorna quants elements s'han processat.
+template <bool Fast>
+LAB3_TARGET_AVX2 static std::size_t NlerpMany_AVX2(const double* a, const double* b, const double* t,
+                                                   std::size_t t_stride, double* out, std::size_t n)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d sign_bit = _mm256_set1_pd(-0.0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d as = _mm256_loadu_pd(a + i * 4), ax = _mm256_loadu_pd(a + i * 4 + 4);
+        __m256d ay = _mm256_loadu_pd(a + i * 4 + 8), az = _mm256_loadu_pd(a + i * 4 + 12);
+        __m256d bs = _mm256_loadu_pd(b + i * 4), bx = _mm256_loadu_pd(b + i * 4 + 4);
+        __m256d by = _mm256_loadu_pd(b + i * 4 + 8), bz = _mm256_loadu_pd(b + i * 4 + 12);
+        Transpose4_AVX2(as, ax, ay, az);
+        Transpose4_AVX2(bs, bx, by, bz);
+
+        __m256d tt = t_stride ? _mm256_loadu_pd(t + i) : _mm256_broadcast_sd(t);
+
+        __m256d d = _mm256_mul_pd(as, bs);
+        d = _mm256_add_pd(d, _mm256_mul_pd(ax, bx));
+        d = _mm256_add_pd(d, _mm256_mul_pd(ay, by));
+        d = _mm256_add_pd(d, _mm256_mul_pd(az, bz));
+        const __m256d neg = _mm256_and_pd(d, sign_bit);   // signe del producte escalar
+        const __m256d ad = _mm256_andnot_pd(sign_bit, d);  // |dot|
+
+        if (Fast) {
+            // Mateix polinomi que SlerpFastT
+            __m256d A = _mm256_sub_pd(_mm256_set1_pd(3.55645), _mm256_mul_pd(ad, _mm256_set1_pd(1.43519)));
+            A = _mm256_add_pd(_mm256_set1_pd(-3.2452), _mm256_mul_pd(ad, A));
+            A = _mm256_add_pd(_mm256_set1_pd(1.0904), _mm256_mul_pd(ad, A));
+            __m256d B = _mm256_add_pd(_mm256_set1_pd(-1.06021), _mm256_mul_pd(ad, _mm256_set1_pd(0.215638)));
+            B = _mm256_add_pd(_mm256_set1_pd(0.848013), _mm256_mul_pd(ad, B));
+            const __m256d th = _mm256_sub_pd(tt, half);
+            const __m256d k = _mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(A, th), th), B);
+            tt = _mm256_add_pd(tt, _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(tt, th), _mm256_sub_pd(tt, one)), k));
+        }
+
+        const __m256d wa = _mm256_sub_pd(one, tt);
+        const __m256d wb = _mm256_xor_pd(tt, neg);
+        __m256d qs = _mm256_add_pd(_mm256_mul_pd(wa, as), _mm256_mul_pd(wb, bs));
+        __m256d qx = _mm256_add_pd(_mm256_mul_pd(wa, ax), _mm256_mul_pd(wb, bx));
+        __m256d qy = _mm256_add_pd(_mm256_mul_pd(wa, ay), _mm256_mul_pd(wb, by));
+        __m256d qz = _mm256_add_pd(_mm256_mul_pd(wa, az), _mm256_mul_pd(wb, bz));
+
+        __m256d n2 = _mm256_mul_pd(qs, qs);
+        n2 = _mm256_add_pd(n2, _mm256_mul_pd(qx, qx));
+        n2 = _mm256_add_pd(n2, _mm256_mul_pd(qy, qy));
+        n2 = _mm256_add_pd(n2, _mm256_mul_pd(qz, qz));
+        const __m256d inv = _mm256_div_pd(one, _mm256_sqrt_pd(n2));
+        qs = _mm256_mul_pd(qs, inv); qx = _mm256_mul_pd(qx, inv);
+        qy = _mm256_mul_pd(qy, inv); qz = _mm256_mul_pd(qz, inv);
+
+        Transpose4_AVX2(qs, qx, qy, qz);
+        _mm256_storeu_pd(out + i * 4, qs);
+        _mm256_storeu_pd(out + i * 4 + 4, qx);
+        _mm256_storeu_pd(out + i * 4 + 8, qy);
+        _mm256_storeu_pd(out + i * 4 + 12, qz);
+    }
+    return i;
+}
+
+#endif
+
+enum class InterpKind { Slerp, Nlerp, SlerpFast };
+
+template <typename T>
+static void InterpMany(InterpKind kind, std::span<const QuatT<T>> a, std::span<const QuatT<T>> b,
+                       const T* t, std::size_t t_stride, std::span<QuatT<T>> out)
+{
+    if (a.size() != b.size() || a.size() != out.size()) {
+        throw std::invalid_argument("Quat interpolacio en lot: mides diferents");
+    }
+    std::size_t i = 0;
+
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (kind != InterpKind::Slerp && GetSimdLevel() >= SimdLevel::AVX2) {
+            static_assert(sizeof(QuatT<double>) == 4 * sizeof(double), "Quat ha de ser s,x,y,z contigus");
+            const double* pa = &a.data()->s;
+            const double* pb = &b.data()->s;
+            double* po = &out.data()->s;
+            i = (kind == InterpKind::SlerpFast)
+                ? NlerpMany_AVX2<true>(pa, pb, t, t_stride, po, a.size())
+                : NlerpMany_AVX2<false>(pa, pb, t, t_stride, po, a.size());
+        }
+    }
+#endif
+
+    for (; i < a.size(); ++i) {
+        const T ti = t[i * t_stride];
+        switch (kind) {
+        case InterpKind::Slerp: out[i] = QuatT<T>::Slerp(a[i], b[i], ti); break;
+        case InterpKind::Nlerp: out[i] = QuatT<T>::Nlerp(a[i], b[i], ti); break;
+        default: out[i] = QuatT<T>::SlerpFast(a[i], b[i], ti); break;
+        }
+    }
+}
+
+static void CheckTSize(std::size_t n, std::size_t nt)
+{
+    if (n != nt) {
+        throw std::invalid_argument("Quat interpolacio en lot: mida de t diferent");
+    }
+}
+
+template <typename T>
+void QuatT<T>::SlerpMany(std::span<const QuatT> a, std::span<const QuatT> b, std::span<const T> t, std::span<QuatT> out)
+{
+    CheckTSize(a.size(), t.size());
+    InterpMany<T>(InterpKind::Slerp, a, b, t.data(), 1, out);
+}
+
+template <typename T>
+void QuatT<T>::SlerpMany(std::span<const QuatT> a, std::span<const QuatT> b, T t, std::span<QuatT> out)
+{
+    InterpMany<T>(InterpKind::Slerp, a, b, &t, 0, out);
+}
+
+template <typename T>
+void QuatT<T>::NlerpMany(std::span<const QuatT> a, std::span<const QuatT> b, std::span<const T> t, std::span<QuatT> out)
+{
+    CheckTSize(a.size(), t.size());
+    InterpMany<T>(InterpKind::Nlerp, a, b, t.data(), 1, out);
+}
+
+template <typename T>
+void QuatT<T>::NlerpMany(std::span<const QuatT> a, std::span<const QuatT> b, T t, std::span<QuatT> out)
+{
+    InterpMany<T>(InterpKind::Nlerp, a, b, &t, 0, out);
+}
+
+template <typename T>
+void QuatT<T>::SlerpFastMany(std::span<const QuatT> a, std::span<const QuatT> b, std::span<const T> t, std::span<QuatT> out)
+{
+    CheckTSize(a.size(), t.size());
+    InterpMany<T>(InterpKind::SlerpFast, a, b, t.data(), 1, out);
+}
+
+template <typename T>
+void QuatT<T>::SlerpFastMany(std::span<const QuatT> a, std::span<const QuatT> b, T t, std::span<QuatT> out)
+{
+    InterpMany<T>(InterpKind::SlerpFast, a, b, &t, 0, out);
+}
+
+// --------------------------------------------------------------------------
+// Rotacio en lot
+// --------------------------------------------------------------------------
+
+static void CheckRotateSize(std::initializer_list<std::size_t> sizes)
+{
+    const std::size_t n = *sizes.begin();
+    for (std::size_t m : sizes) {
+        if (m != n) {
+            throw std::invalid_argument("Quat::RotateMany: mides diferents");
+        }
+    }
+}
+
+// Matriu equivalent a Rotate: R = I + 2s[a]x + 2([a]x)^2. Es lineal en v, aixi
+// que coincideix amb Rotate tambe per a q no unitari (sense normalitzar)
+template <typename T>
+static void RotateMatrix(const QuatT<T>& q, T r[9])
+{
+    const T xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const T xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const T sx = q.s * q.x, sy = q.s * q.y, sz = q.s * q.z;
+    r[0] = 1 - 2 * (yy + zz); r[1] = 2 * (xy - sz);     r[2] = 2 * (xz + sy);
+    r[3] = 2 * (xy + sz);     r[4] = 1 - 2 * (xx + zz); r[5] = 2 * (yz - sx);
+    r[6] = 2 * (xz - sy);     r[7] = 2 * (yz + sx);     r[8] = 1 - 2 * (xx + yy);
+}
+
+template <typename T>
+void QuatT<T>::RotateMany(std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out) const
+{
+    CheckRotateSize({ in.size(), out.size() });
+    if (in.size() < RotateMatrixMinBatch) {
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            const Vec3T<T> v = in[i];
+            RotateCross(*this, v.x, v.y, v.z, out[i].x, out[i].y, out[i].z);
+        }
+        return;
+    }
+    T r[9];
+    RotateMatrix(*this, r);
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        const Vec3T<T> v = in[i];
+        out[i] = { r[0] * v.x + r[1] * v.y + r[2] * v.z,
+                   r[3] * v.x + r[4] * v.y + r[5] * v.z,
+                   r[6] * v.x + r[7] * v.y + r[8] * v.z };
+    }
+}
+
+template <typename T>
+void QuatT<T>::RotateMany(std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                          std::span<T> ox, std::span<T> oy, std::span<T> oz) const
+{
+    CheckRotateSize({ x.size(), y.size(), z.size(), ox.size(), oy.size(), oz.size() });
+    const std::size_t n = x.size();
+    if (n < RotateMatrixMinBatch) {
+        for (std::size_t i = 0; i < n; ++i) {
+            RotateCross(*this, x[i], y[i], z[i], ox[i], oy[i], oz[i]);
+        }
+        return;
+    }
+    T r[9];
+    RotateMatrix(*this, r);
+    const T r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4], r5 = r[5], r6 = r[6], r7 = r[7], r8 = r[8];
+    // Bucle sense branques sobre arrays separats: el compilador el vectoritza
+    for (std::size_t i = 0; i < n; ++i) {
+        const T vx = x[i], vy = y[i], vz = z[i];
+        ox[i] = r0 * vx + r1 * vy + r2 * vz;
+        oy[i] = r3 * vx + r4 * vy + r5 * vz;
+        oz[i] = r6 * vx + r7 * vy + r8 * vz;
+    }
+}
+
+template <typename T>
+void QuatT<T>::RotateMany(std::span<const QuatT> q, std::span<const Vec3T<T>> in, std::span<Vec3T<T>> out)
+{
+    CheckRotateSize({ q.size(), in.size(), out.size() });
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        const Vec3T<T> v = in[i];
+        RotateCross(q[i], v.x, v.y, v.z, out[i].x, out[i].y, out[i].z);
+    }
+}
+
+template <typename T>
+void QuatT<T>::RotateMany(std::span<const QuatT> q, std::span<const T> x, std::span<const T> y, std::span<const T> z,
+                          std::span<T> ox, std::span<T> oy, std::span<T> oz)
+{
+    CheckRotateSize({ q.size(), x.size(), y.size(), z.size(), ox.size(), oy.size(), oz.size() });
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        RotateCross(q[i], x[i], y[i], z[i], ox[i], oy[i], oz[i]);
+    }
+}
+
+template struct QuatT<float>;
+template struct QuatT<double>;
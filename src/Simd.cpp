@@ -0,0 +1,101 @@
+#include "Simd.hpp"
+#include <atomic>
+
+#if LAB3_SIMD_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+static SimdLevel QueryCpu()
+{
+#if !LAB3_SIMD_X86
+    return SimdLevel::Scalar;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = { 0 };
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    // El SO ha de guardar els registres YMM (XCR0 bits 1 i 2)
+    bool ymm_os = false;
+    if (osxsave && avx) {
+        ymm_os = (_xgetbv(0) & 0x6) == 0x6;
+    }
+
+    bool avx2 = false;
+    if (max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    if (ymm_os && avx2 && fma) return SimdLevel::FMA;
+    if (ymm_os && avx2) return SimdLevel::AVX2;
+    if (sse2) return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+#else
+    __builtin_cpu_init();
+    // __builtin_cpu_supports ja te en compte el suport del SO per AVX
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::FMA;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+#endif
+}
+
+static bool QueryF16C()
+{
+#if !LAB3_SIMD_X86
+    return false;
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = { 0 };
+    __cpuid(info, 1);
+    return (info[2] & (1 << 29)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("f16c");
+#endif
+}
+
+bool HasF16C()
+{
+    static const bool f16c = QueryF16C();
+    return f16c;
+}
+
+SimdLevel DetectSimdLevel()
+{
+    static const SimdLevel detected = QueryCpu();
+    return detected;
+}
+
+static std::atomic<int>& ActiveLevel()
+{
+    static std::atomic<int> level{ static_cast<int>(DetectSimdLevel()) };
+    return level;
+}
+
+SimdLevel GetSimdLevel()
+{
+    return static_cast<SimdLevel>(ActiveLevel().load(std::memory_order_relaxed));
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+    // Mai per sobre del que suporta la maquina
+    if (level > DetectSimdLevel()) level = DetectSimdLevel();
+    ActiveLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char* ToString(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::SSE2: return "SSE2";
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::FMA: return "AVX2+FMA";
+    default: return "Scalar";
+    }
+}
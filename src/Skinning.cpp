@@ -0,0 +1,154 @@
+#include "Skinning.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+template <typename T>
+void SkinningT<T>::BuildPalette(std::span<const Matrix4x4T<T>> bones, std::span<const Matrix4x4T<T>> inverseBind,
+                                std::span<Affine3x4T<T>> palette)
+{
+    if (bones.size() != inverseBind.size() || bones.size() != palette.size()) {
+        throw std::invalid_argument("Skinning::BuildPalette: mides diferents");
+    }
+    for (std::size_t i = 0; i < bones.size(); ++i) {
+        palette[i] = Affine3x4T<T>::FromMatrix4x4(bones[i]) * Affine3x4T<T>::FromMatrix4x4(inverseBind[i]);
+    }
+}
+
+template <typename T>
+static bool HasNormals(const SkinStreamsT<T>& in)
+{
+    return !in.nx.empty();
+}
+
+template <typename T>
+static void Validate(std::size_t paletteSize, const SkinStreamsT<T>& in, const SkinTargetsT<T>& out)
+{
+    const std::size_t n = in.x.size();
+    bool ok = in.y.size() == n && in.z.size() == n && in.indices.size() == 4 * n && in.weights.size() == 4 * n
+        && out.x.size() == n && out.y.size() == n && out.z.size() == n;
+    if (HasNormals(in)) {
+        ok = ok && in.nx.size() == n && in.ny.size() == n && in.nz.size() == n
+            && out.nx.size() == n && out.ny.size() == n && out.nz.size() == n;
+    }
+    if (!ok) {
+        throw std::invalid_argument("Skinning::SkinLinear: mides dels streams diferents");
+    }
+    if (n != 0 && *std::max_element(in.indices.begin(), in.indices.end()) >= paletteSize) {
+        throw std::invalid_argument("Skinning::SkinLinear: index d'os fora de la paleta");
+    }
+}
+
+// Vertexs [b, e) sense validacio
+template <typename T>
+static void SkinRange_Scalar(const Affine3x4T<T>* pal, const SkinStreamsT<T>& in, const SkinTargetsT<T>& out,
+                             std::size_t b, std::size_t e)
+{
+    const bool normals = HasNormals(in);
+    for (std::size_t i = b; i < e; ++i) {
+        T B[12] = { 0 };
+        for (int k = 0; k < 4; ++k) {
+            const T w = in.weights[4 * i + k];
+            const T* m = pal[in.indices[4 * i + k]].m;
+            for (int j = 0; j < 12; ++j) {
+                B[j] += w * m[j];
+            }
+        }
+        const T px = in.x[i], py = in.y[i], pz = in.z[i];
+        out.x[i] = B[0] * px + B[1] * py + B[2] * pz + B[3];
+        out.y[i] = B[4] * px + B[5] * py + B[6] * pz + B[7];
+        out.z[i] = B[8] * px + B[9] * py + B[10] * pz + B[11];
+        if (normals) {
+            const T vx = in.nx[i], vy = in.ny[i], vz = in.nz[i];
+            out.nx[i] = B[0] * vx + B[1] * vy + B[2] * vz;
+            out.ny[i] = B[4] * vx + B[5] * vy + B[6] * vz;
+            out.nz[i] = B[8] * vx + B[9] * vy + B[10] * vz;
+        }
+    }
+}
+
+#if LAB3_SIMD_X86
+// Quatre vertexs per iteracio. La barreja es fa per files (cada fila d'una
+// Affine3x4 son 4 doubles contigus: carregues directes, sense gathers) i
+// despres es transposa perque cada carril sigui un vertex i la transformacio
+// es faci directament sobre els streams SoA.
+LAB3_TARGET_AVX2 static std::size_t SkinRange_AVX2(const Affine3x4T<double>* pal, const SkinStreamsT<double>& in,
+                                                   const SkinTargetsT<double>& out, std::size_t b, std::size_t e)
+{
+    const bool normals = HasNormals(in);
+    const std::uint16_t* idx = in.indices.data();
+    const double* wts = in.weights.data();
+    std::size_t i = b;
+    for (; i + 4 <= e; i += 4) {
+        __m256d r0[4], r1[4], r2[4];
+        for (int v = 0; v < 4; ++v) {
+            __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd(), a2 = _mm256_setzero_pd();
+            for (int k = 0; k < 4; ++k) {
+                const std::size_t s = 4 * (i + v) + k;
+                const double* m = pal[idx[s]].m;
+                const __m256d w = _mm256_set1_pd(wts[s]);
+                a0 = _mm256_add_pd(a0, _mm256_mul_pd(w, _mm256_loadu_pd(m)));
+                a1 = _mm256_add_pd(a1, _mm256_mul_pd(w, _mm256_loadu_pd(m + 4)));
+                a2 = _mm256_add_pd(a2, _mm256_mul_pd(w, _mm256_loadu_pd(m + 8)));
+            }
+            r0[v] = a0; r1[v] = a1; r2[v] = a2;
+        }
+        // Despres de transposar, rX[j] = element (X, j) de les quatre matrius
+        Transpose4_AVX2(r0[0], r0[1], r0[2], r0[3]);
+        Transpose4_AVX2(r1[0], r1[1], r1[2], r1[3]);
+        Transpose4_AVX2(r2[0], r2[1], r2[2], r2[3]);
+
+#define ROW(r, X, Y, Z) _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r[0], X), _mm256_mul_pd(r[1], Y)), _mm256_mul_pd(r[2], Z))
+        const __m256d px = _mm256_loadu_pd(&in.x[i]), py = _mm256_loadu_pd(&in.y[i]), pz = _mm256_loadu_pd(&in.z[i]);
+        _mm256_storeu_pd(&out.x[i], _mm256_add_pd(ROW(r0, px, py, pz), r0[3]));
+        _mm256_storeu_pd(&out.y[i], _mm256_add_pd(ROW(r1, px, py, pz), r1[3]));
+        _mm256_storeu_pd(&out.z[i], _mm256_add_pd(ROW(r2, px, py, pz), r2[3]));
+        if (normals) {
+            const __m256d vx = _mm256_loadu_pd(&in.nx[i]), vy = _mm256_loadu_pd(&in.ny[i]), vz = _mm256_loadu_pd(&in.nz[i]);
+            _mm256_storeu_pd(&out.nx[i], ROW(r0, vx, vy, vz));
+            _mm256_storeu_pd(&out.ny[i], ROW(r1, vx, vy, vz));
+            _mm256_storeu_pd(&out.nz[i], ROW(r2, vx, vy, vz));
+        }
+#undef ROW
+    }
+    return i;
+}
+#endif
+
+template <typename T>
+static void SkinRange(const Affine3x4T<T>* pal, const SkinStreamsT<T>& in, const SkinTargetsT<T>& out,
+                      std::size_t b, std::size_t e)
+{
+#if LAB3_SIMD_X86
+    if constexpr (std::is_same_v<T, double>) {
+        if (GetSimdLevel() >= SimdLevel::AVX2) {
+            b = SkinRange_AVX2(pal, in, out, b, e);
+        }
+    }
+#endif
+    SkinRange_Scalar(pal, in, out, b, e);
+}
+
+template <typename T>
+void SkinningT<T>::SkinLinear(std::span<const Affine3x4T<T>> palette, const SkinStreamsT<T>& in, const SkinTargetsT<T>& out)
+{
+    Validate(palette.size(), in, out);
+    SkinRange(palette.data(), in, out, 0, in.x.size());
+}
+
+template <typename T>
+void SkinningT<T>::SkinLinearParallel(std::span<const Affine3x4T<T>> palette, const SkinStreamsT<T>& in,
+                                      const SkinTargetsT<T>& out, ThreadPool& pool, std::size_t grain)
+{
+    Validate(palette.size(), in, out);
+    if (grain == 0) {
+        // ~64 KiB de streams per tros (posicio, normal, 4 pesos i 4 indexs)
+        grain = std::max<std::size_t>(64, (64 * 1024 / (16 * sizeof(T) + 8)) & ~std::size_t(3));
+    }
+    pool.ParallelFor(in.x.size(), grain, [&](std::size_t b, std::size_t e) {
+        SkinRange(palette.data(), in, out, b, e);
+    });
+}
+
+template struct SkinningT<float>;
+template struct SkinningT<double>;
@@ -0,0 +1,166 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+
+// Pool i index de cua propia del fil actual (nomes per als treballadors)
+static thread_local const void* t_pool = nullptr;
+static thread_local std::size_t t_index = 0;
+
+struct ThreadPool::Job
+{
+    const std::function<void(std::size_t, std::size_t)>* body = nullptr;
+    std::atomic<std::size_t> remaining{ 0 };
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+    if (threads == 0) {
+        threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i + 1 < threads; ++i) {
+        m_threads.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) {
+        t.join();
+    }
+}
+
+ThreadPool& ThreadPool::Default()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::Pop(std::size_t self, Task& task)
+{
+    // El propietari treu pel darrere: els trossos mes propers als que acaba de fer
+    Queue& q = *m_queues[self];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) {
+        return false;
+    }
+    task = q.tasks.back();
+    q.tasks.pop_back();
+    m_pending.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::Steal(std::size_t self, Task& task)
+{
+    const std::size_t n = m_queues.size();
+    for (std::size_t k = 1; k < n; ++k) {
+        Queue& q = *m_queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            continue;
+        }
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        m_pending.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::Execute(const Task& task)
+{
+    Job& job = *task.job;
+    try {
+        (*job.body)(task.begin, task.end);
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(job.errorMutex);
+        if (!job.error) {
+            job.error = std::current_exception();
+        }
+    }
+    job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ThreadPool::WorkerLoop(std::size_t self)
+{
+    t_pool = this;
+    t_index = self;
+    for (;;) {
+        Task task;
+        if (Pop(self, task) || Steal(self, task)) {
+            Execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_pending.load(std::memory_order_relaxed) > 0; });
+        if (m_stop && m_pending.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(std::size_t n, std::size_t grain,
+                             const std::function<void(std::size_t, std::size_t)>& body)
+{
+    if (n == 0) {
+        return;
+    }
+    const std::size_t workers = Size();
+    if (grain == 0) {
+        // Uns quants trossos per fil perque el robatori pugui equilibrar
+        grain = std::max<std::size_t>(1, (n + 4 * workers - 1) / (4 * workers));
+    }
+    const std::size_t chunks = (n + grain - 1) / grain;
+    if (workers == 1 || chunks == 1) {
+        body(0, n);
+        return;
+    }
+
+    Job job;
+    job.body = &body;
+    job.remaining.store(chunks, std::memory_order_relaxed);
+
+    // Trossos contigus per cua: cada fil comenca amb un bloc continu de memoria
+    const std::size_t self = (t_pool == this) ? t_index : workers - 1;
+    for (std::size_t w = 0; w < workers; ++w) {
+        const std::size_t c0 = chunks * w / workers, c1 = chunks * (w + 1) / workers;
+        if (c0 == c1) {
+            continue;
+        }
+        Queue& q = *m_queues[(self + w) % workers];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        // En ordre invers: Pop treu pel darrere i aixi recorre el bloc endavant
+        for (std::size_t c = c1; c-- > c0;) {
+            q.tasks.push_back({ &job, c * grain, std::min(n, (c + 1) * grain) });
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_pending.fetch_add(chunks, std::memory_order_relaxed);
+    }
+    m_wake.notify_all();
+
+    // El fil que crida tambe treballa; si no queda res a robar espera els altres
+    while (job.remaining.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (Pop(self, task) || Steal(self, task)) {
+            Execute(task);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
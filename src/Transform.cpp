@@ -0,0 +1,63 @@
+#include "Transform.hpp"
+
+template <typename T>
+TransformT<T> TransformT<T>::FromMatrix(const Matrix4x4T<T>& M)
+{
+    TransformT X;
+    M.Decompose(X.m_t, X.m_q, X.m_s);
+    return X;
+}
+
+template <typename T>
+void TransformT<T>::SetRotation(const Matrix3x3T<T>& R)
+{
+    m_q = QuatT<T>::FromMatrix3x3(R);
+    ++m_version;
+}
+
+template <typename T>
+const Matrix4x4T<T>& TransformT<T>::Matrix() const
+{
+    if (m_matrixVersion != m_version) {
+        m_matrix = Matrix4x4T<T>::FromTRS(m_t, m_q, m_s);
+        m_matrixVersion = m_version;
+    }
+    return m_matrix;
+}
+
+template <typename T>
+const Matrix4x4T<T>& TransformT<T>::Inverse() const
+{
+    if (m_inverseVersion != m_version) {
+        // La fila j de la inversa es la columna j de R dividida per s_j
+        const Matrix3x3T<T> R = m_q.ToMatrix3x3();
+        const T scales[3] = { m_s.x, m_s.y, m_s.z };
+        Matrix4x4T<T> M;
+        for (int j = 0; j < 3; ++j) {
+            const T inv = (std::fabs(scales[j]) > Tol<T>()) ? T(1) / scales[j] : T(0);
+            M.At(j, 0) = R.At(0, j) * inv;
+            M.At(j, 1) = R.At(1, j) * inv;
+            M.At(j, 2) = R.At(2, j) * inv;
+        }
+        for (int i = 0; i < 3; ++i) {
+            M.At(i, 3) = -(M.At(i, 0) * m_t.x + M.At(i, 1) * m_t.y + M.At(i, 2) * m_t.z);
+        }
+        M.At(3, 3) = 1;
+        m_inverse = M;
+        m_inverseVersion = m_version;
+    }
+    return m_inverse;
+}
+
+template <typename T>
+const Matrix3x3T<T>& TransformT<T>::NormalMatrix() const
+{
+    if (m_normalVersion != m_version) {
+        m_normal = Matrix().NormalMatrix();
+        m_normalVersion = m_version;
+    }
+    return m_normal;
+}
+
+template class TransformT<float>;
+template class TransformT<double>;
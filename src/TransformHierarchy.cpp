@@ -0,0 +1,120 @@
+#include "TransformHierarchy.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+template <typename T>
+std::size_t TransformHierarchyT<T>::AddNode(std::size_t parent, const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s)
+{
+    if (parent != NoParent && parent >= Size()) {
+        throw std::invalid_argument("TransformHierarchy::AddNode: el pare ha d'existir abans que el fill");
+    }
+    const std::size_t i = Size();
+    m_parent.push_back(parent);
+    m_t.push_back(t);
+    m_q.push_back(q);
+    m_s.push_back(s);
+    m_local.push_back(Matrix4x4T<T>::Identity());
+    m_world.push_back(Matrix4x4T<T>::Identity());
+    m_dirty.push_back(0);
+    MarkDirty(i);
+    return i;
+}
+
+template <typename T>
+std::size_t TransformHierarchyT<T>::AddNode(std::size_t parent)
+{
+    return AddNode(parent, Vec3T<T>{ 0, 0, 0 }, QuatT<T>{}, Vec3T<T>{ 1, 1, 1 });
+}
+
+template <typename T>
+void TransformHierarchyT<T>::Reserve(std::size_t n)
+{
+    m_parent.reserve(n);
+    m_t.reserve(n);
+    m_q.reserve(n);
+    m_s.reserve(n);
+    m_local.reserve(n);
+    m_world.reserve(n);
+    m_dirty.reserve(n);
+}
+
+template <typename T>
+void TransformHierarchyT<T>::Clear()
+{
+    m_parent.clear();
+    m_t.clear();
+    m_q.clear();
+    m_s.clear();
+    m_local.clear();
+    m_world.clear();
+    m_dirty.clear();
+    m_firstDirty = 0;
+}
+
+template <typename T>
+void TransformHierarchyT<T>::MarkDirty(std::size_t i)
+{
+    m_dirty[i] = 1;
+    m_firstDirty = std::min(m_firstDirty, i);
+}
+
+template <typename T>
+void TransformHierarchyT<T>::SetLocal(std::size_t i, const Vec3T<T>& t, const QuatT<T>& q, const Vec3T<T>& s)
+{
+    m_t.at(i) = t;
+    m_q[i] = q;
+    m_s[i] = s;
+    MarkDirty(i);
+}
+
+template <typename T>
+void TransformHierarchyT<T>::SetTranslation(std::size_t i, const Vec3T<T>& t)
+{
+    m_t.at(i) = t;
+    MarkDirty(i);
+}
+
+template <typename T>
+void TransformHierarchyT<T>::SetRotation(std::size_t i, const QuatT<T>& q)
+{
+    m_q.at(i) = q;
+    MarkDirty(i);
+}
+
+template <typename T>
+void TransformHierarchyT<T>::SetScale(std::size_t i, const Vec3T<T>& s)
+{
+    m_s.at(i) = s;
+    MarkDirty(i);
+}
+
+template <typename T>
+std::size_t TransformHierarchyT<T>::UpdateWorld()
+{
+    // Els pares precedeixen els fills, aixi que en arribar al node i el flag
+    // del pare ja es definitiu: un sol recorregut propaga la brutor cap avall.
+    // Cap node anterior a m_firstDirty pot ser brut ni tenir un pare brut.
+    const std::size_t n = Size();
+    std::size_t updated = 0;
+    for (std::size_t i = m_firstDirty; i < n; ++i) {
+        const std::size_t p = m_parent[i];
+        if (p != NoParent) {
+            m_dirty[i] |= m_dirty[p];
+        }
+        if (!m_dirty[i]) {
+            continue;
+        }
+        m_local[i] = Matrix4x4T<T>::FromTRS(m_t[i], m_q[i], m_s[i]);
+        m_world[i] = (p == NoParent) ? m_local[i] : m_world[p].MultiplyAffine(m_local[i]);
+        ++updated;
+    }
+    // Els flags es netegen en una segona passada perque els fills els llegeixen
+    if (m_firstDirty < n) {
+        std::fill(m_dirty.begin() + m_firstDirty, m_dirty.end(), std::uint8_t(0));
+    }
+    m_firstDirty = n;
+    return updated;
+}
+
+template struct TransformHierarchyT<float>;
+template struct TransformHierarchyT<double>;
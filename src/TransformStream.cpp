@@ -0,0 +1,276 @@
+#include "TransformStream.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// --------------------------------------------------------------------------
+// Capcalera
+// --------------------------------------------------------------------------
+
+enum class RecordKind : std::uint32_t
+{
+    Matrix4x4 = 1,
+    Quat = 2,
+    Vec3 = 3,
+    TRS = 4
+};
+
+struct StreamHeader
+{
+    char magic[4];                 // "L3TS"
+    std::uint32_t version;
+    std::uint32_t byteOrder;       // 0x01020304 escrit en l'ordre de la maquina
+    std::uint32_t kind;            // RecordKind
+    std::uint32_t scalarSize;      // 4 o 8
+    std::uint32_t recordSize;
+    std::uint64_t count;
+    std::uint64_t dataOffset;
+    std::uint64_t checksum;
+    std::uint8_t reserved[16];
+};
+static_assert(sizeof(StreamHeader) == 64, "La capcalera ha d'ocupar 64 bytes");
+
+static constexpr std::size_t DataOffset = 64;
+static constexpr std::uint32_t ByteOrderMark = 0x01020304u;
+
+template <typename R> struct RecordTraits;
+template <typename T> struct RecordTraits<Matrix4x4T<T>> { static constexpr RecordKind Kind = RecordKind::Matrix4x4; using Scalar = T; };
+template <typename T> struct RecordTraits<QuatT<T>> { static constexpr RecordKind Kind = RecordKind::Quat; using Scalar = T; };
+template <typename T> struct RecordTraits<Vec3T<T>> { static constexpr RecordKind Kind = RecordKind::Vec3; using Scalar = T; };
+template <typename T> struct RecordTraits<TRSRecordT<T>> { static constexpr RecordKind Kind = RecordKind::TRS; using Scalar = T; };
+
+template <typename R>
+static StreamHeader MakeHeader(std::uint64_t count, std::uint64_t checksum)
+{
+    StreamHeader h{};
+    std::memcpy(h.magic, "L3TS", 4);
+    h.version = TransformStreamVersion;
+    h.byteOrder = ByteOrderMark;
+    h.kind = static_cast<std::uint32_t>(RecordTraits<R>::Kind);
+    h.scalarSize = sizeof(typename RecordTraits<R>::Scalar);
+    h.recordSize = sizeof(R);
+    h.count = count;
+    h.dataOffset = DataOffset;
+    h.checksum = checksum;
+    return h;
+}
+
+// --------------------------------------------------------------------------
+// Checksum: Fletcher sobre paraules de 32 bits amb sumes de 64 bits (mod 2^64)
+// --------------------------------------------------------------------------
+
+void StreamChecksum::Update(const void* data, std::size_t bytes)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t a = sum1, b = sum2;
+    for (std::size_t i = 0; i + 4 <= bytes; i += 4) {
+        std::uint32_t w;
+        std::memcpy(&w, p + i, 4);
+        a += w;
+        b += a;
+    }
+    sum1 = a;
+    sum2 = b;
+}
+
+// --------------------------------------------------------------------------
+// Escriptor
+// --------------------------------------------------------------------------
+
+template <typename R>
+TransformStreamWriter<R>::TransformStreamWriter(const std::string& path)
+    : m_out(path, std::ios::binary | std::ios::trunc)
+{
+    static_assert(std::is_trivially_copyable_v<R> && sizeof(R) % 4 == 0, "Registre no serialitzable");
+    if (!m_out) {
+        throw std::runtime_error("TransformStreamWriter: no es pot obrir " + path);
+    }
+    // Capcalera provisional; Close la reescriu amb el recompte i el checksum
+    const StreamHeader h = MakeHeader<R>(0, 0);
+    m_out.write(reinterpret_cast<const char*>(&h), sizeof h);
+}
+
+template <typename R>
+TransformStreamWriter<R>::~TransformStreamWriter()
+{
+    try {
+        Close();
+    } catch (...) {
+    }
+}
+
+template <typename R>
+void TransformStreamWriter<R>::Write(std::span<const R> records)
+{
+    if (!m_out.is_open()) {
+        throw std::runtime_error("TransformStreamWriter::Write: el fitxer ja esta tancat");
+    }
+    const std::size_t bytes = records.size_bytes();
+    m_out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(bytes));
+    if (!m_out) {
+        throw std::runtime_error("TransformStreamWriter::Write: error d'escriptura");
+    }
+    m_checksum.Update(records.data(), bytes);
+    m_count += records.size();
+}
+
+template <typename R>
+void TransformStreamWriter<R>::Close()
+{
+    if (!m_out.is_open()) return;
+    const StreamHeader h = MakeHeader<R>(m_count, m_checksum.Value());
+    m_out.seekp(0);
+    m_out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    const bool ok = static_cast<bool>(m_out);
+    m_out.close();
+    if (!ok || m_out.fail()) {
+        throw std::runtime_error("TransformStreamWriter::Close: error d'escriptura");
+    }
+}
+
+// --------------------------------------------------------------------------
+// Fitxer mapejat
+// --------------------------------------------------------------------------
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("MappedFile: no es pot obrir " + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: no es pot llegir la mida de " + path);
+    }
+    m_file = file;
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0) return;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: no es pot mapejar " + path);
+    }
+    m_mapping = mapping;
+    m_data = static_cast<const std::byte*>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+    if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+}
+#else
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MappedFile: no es pot obrir " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedFile: no es pot llegir la mida de " + path);
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size != 0) {
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: no es pot mapejar " + path);
+        }
+        // La pista es llegeix sequencialment
+        ::madvise(p, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const std::byte*>(p);
+    }
+    // El mapeig es mante despres de tancar el descriptor
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data) ::munmap(const_cast<std::byte*>(m_data), m_size);
+}
+#endif
+
+// --------------------------------------------------------------------------
+// Lector
+// --------------------------------------------------------------------------
+
+template <typename R>
+TransformStreamReader<R>::TransformStreamReader(const std::string& path, bool verify)
+    : m_file(path)
+{
+    if (m_file.Size() < sizeof(StreamHeader)) {
+        throw std::runtime_error("TransformStreamReader: fitxer massa curt " + path);
+    }
+    StreamHeader h;
+    std::memcpy(&h, m_file.Data(), sizeof h);
+    const StreamHeader expected = MakeHeader<R>(0, 0);
+    if (std::memcmp(h.magic, expected.magic, 4) != 0) {
+        throw std::runtime_error("TransformStreamReader: no es un fitxer de transformacions " + path);
+    }
+    if (h.version != TransformStreamVersion) {
+        throw std::runtime_error("TransformStreamReader: versio no suportada " + path);
+    }
+    if (h.byteOrder != ByteOrderMark) {
+        throw std::runtime_error("TransformStreamReader: ordre de bytes diferent " + path);
+    }
+    if (h.kind != expected.kind || h.scalarSize != expected.scalarSize || h.recordSize != expected.recordSize) {
+        throw std::runtime_error("TransformStreamReader: tipus de registre diferent " + path);
+    }
+    // L'escriptor sempre posa les dades a DataOffset: qualsevol altre valor
+    // (p. ex. 0, que solaparia la capcalera) es un fitxer corrupte
+    if (h.dataOffset != DataOffset) {
+        throw std::runtime_error("TransformStreamReader: offset de dades incorrecte " + path);
+    }
+    if (h.count > (m_file.Size() - DataOffset) / sizeof(R)) {
+        throw std::runtime_error("TransformStreamReader: fitxer truncat " + path);
+    }
+    m_checksum = h.checksum;
+    m_records = { reinterpret_cast<const R*>(m_file.Data() + DataOffset), static_cast<std::size_t>(h.count) };
+    if (verify && !VerifyChecksum()) {
+        throw std::runtime_error("TransformStreamReader: checksum incorrecte " + path);
+    }
+}
+
+template <typename R>
+bool TransformStreamReader<R>::VerifyChecksum() const
+{
+    StreamChecksum c;
+    c.Update(m_records.data(), m_records.size_bytes());
+    return c.Value() == m_checksum;
+}
+
+#define LAB3_STREAM_INSTANTIATE(R)           \
+    template class TransformStreamWriter<R>; \
+    template class TransformStreamReader<R>;
+LAB3_STREAM_INSTANTIATE(Matrix4x4T<float>)
+LAB3_STREAM_INSTANTIATE(Matrix4x4T<double>)
+LAB3_STREAM_INSTANTIATE(QuatT<float>)
+LAB3_STREAM_INSTANTIATE(QuatT<double>)
+LAB3_STREAM_INSTANTIATE(Vec3T<float>)
+LAB3_STREAM_INSTANTIATE(Vec3T<double>)
+LAB3_STREAM_INSTANTIATE(TRSRecordT<float>)
+LAB3_STREAM_INSTANTIATE(TRSRecordT<double>)
+#undef LAB3_STREAM_INSTANTIATE